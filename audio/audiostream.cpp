@@ -25,6 +25,8 @@
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/queue.h"
+#include "common/system.h"
+#include "common/timer.h"
 #include "common/util.h"
 
 #include "audio/audiostream.h"
@@ -466,6 +468,342 @@ AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp
 	return new LimitingAudioStream(parentStream, length, disposeAfterUse);
 }
 
+#pragma mark -
+#pragma mark --- DecodeAheadAudioStream ---
+#pragma mark -
+
+/**
+ * Decodes the parent stream ahead of time. The mixer reads it through a
+ * DecodeAheadStreamRef, which hands it to DecodeAheadWorker for deletion,
+ * so that deleting it never waits for the timer proc. An underrun waits
+ * for the timer proc to finish at most one chunk.
+ */
+class DecodeAheadAudioStream : public SeekableAudioStream {
+public:
+	DecodeAheadAudioStream(SeekableAudioStream *parentStream, uint32 aheadMillis, DisposeAfterUse::Flag disposeAfterUse);
+	~DecodeAheadAudioStream();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool endOfData() const;
+	bool isStereo() const { return _isStereo; }
+	int getRate() const { return _rate; }
+
+	bool seek(const Timestamp &where);
+	Timestamp getLength() const { return _parent->getLength(); }
+
+	/**
+	 * Top up the decoded samples, called by the decode ahead timer proc.
+	 * Decodes at most kFillChunks chunks, so that the other timer procs
+	 * are not held up.
+	 */
+	void fill();
+
+private:
+	enum {
+		/** Number of samples decoded from the parent stream at once */
+		kDecodeChunk = 2048,
+		/** Maximal number of chunks decoded per fill() */
+		kFillChunks = 4,
+		/**
+		 * Number of samples decoded when starting or seeking, enough for
+		 * a mixer callback of 8192 stereo frames
+		 */
+		kPrimeSamples = 8 * kDecodeChunk
+	};
+
+	/**
+	 * Decode a chunk, unless the ring buffer holds at least the given
+	 * number of samples already. The caller must hold _decodeMutex.
+	 * @return whether a chunk was decoded
+	 */
+	bool decodeChunk(uint32 target);
+
+	/**
+	 * Decode until the ring buffer holds at least the given number of
+	 * samples. The caller must hold _decodeMutex.
+	 */
+	void decode(uint32 target);
+
+	/** Copy decoded samples out of the ring buffer. */
+	int copyOut(int16 *buffer, int numSamples);
+
+	Common::DisposablePtr<SeekableAudioStream> _parent;
+	const bool _isStereo;
+	const int _rate;
+
+	/** Serializes access to the parent stream. */
+	Common::Mutex _decodeMutex;
+	/** Guards the ring buffer positions, never held while decoding. */
+	Common::Mutex _bufferMutex;
+
+	int16 *_ring;
+	uint32 _ringSize;
+	uint32 _readPos, _writePos, _filled;
+	bool _parentEnded;
+
+	uint32 _decodedSamples;
+	uint32 _decodeTime;
+	uint32 _underruns;
+};
+
+/**
+ * Runs the decoding of all decode ahead streams from a single timer proc.
+ * The timer manager only allows one slot per callback function, so the
+ * streams register here instead of installing a proc each.
+ *
+ * _mutex only guards the stream list and is never held while decoding.
+ */
+class DecodeAheadWorker {
+public:
+	static void addStream(DecodeAheadAudioStream *stream);
+
+	/**
+	 * Unregister the stream and delete it. If the timer proc is filling
+	 * the stream right now, it deletes the stream once it is done instead.
+	 */
+	static void releaseStream(DecodeAheadAudioStream *stream);
+
+private:
+	DecodeAheadWorker() : _filling(0), _fillingReleased(false) {}
+
+	static void timerProc(void *refCon);
+
+	Common::Mutex _mutex;
+	Common::Array<DecodeAheadAudioStream *> _streams;
+	DecodeAheadAudioStream *_filling;
+	bool _fillingReleased;
+
+	static DecodeAheadWorker *_instance;
+};
+
+DecodeAheadWorker *DecodeAheadWorker::_instance = 0;
+
+void DecodeAheadWorker::addStream(DecodeAheadAudioStream *stream) {
+	if (!_instance) {
+		// The proc stays installed once created. It has to take _mutex, so
+		// removing it again when idle could deadlock with the timer thread.
+		_instance = new DecodeAheadWorker();
+		g_system->getTimerManager()->installTimerProc(&timerProc, 10000, _instance, "decodeAhead");
+	}
+
+	Common::StackLock lock(_instance->_mutex);
+	_instance->_streams.push_back(stream);
+}
+
+void DecodeAheadWorker::releaseStream(DecodeAheadAudioStream *stream) {
+	{
+		Common::StackLock lock(_instance->_mutex);
+		for (uint i = 0; i < _instance->_streams.size(); ++i) {
+			if (_instance->_streams[i] == stream) {
+				_instance->_streams.remove_at(i);
+				break;
+			}
+		}
+
+		if (_instance->_filling == stream) {
+			_instance->_fillingReleased = true;
+			return;
+		}
+	}
+
+	delete stream;
+}
+
+void DecodeAheadWorker::timerProc(void *refCon) {
+	DecodeAheadWorker *worker = (DecodeAheadWorker *)refCon;
+
+	// A stream released meanwhile shifts the list, so one of the others
+	// might be skipped. It gets filled on the next call then.
+	for (uint i = 0; ; ++i) {
+		DecodeAheadAudioStream *stream;
+		{
+			Common::StackLock lock(worker->_mutex);
+			if (i >= worker->_streams.size())
+				break;
+			stream = worker->_filling = worker->_streams[i];
+		}
+
+		stream->fill();
+
+		bool released;
+		{
+			Common::StackLock lock(worker->_mutex);
+			released = worker->_fillingReleased;
+			worker->_filling = 0;
+			worker->_fillingReleased = false;
+		}
+
+		if (released)
+			delete stream;
+	}
+}
+
+DecodeAheadAudioStream::DecodeAheadAudioStream(SeekableAudioStream *parentStream, uint32 aheadMillis, DisposeAfterUse::Flag disposeAfterUse)
+    : _parent(parentStream, disposeAfterUse), _isStereo(parentStream->isStereo()), _rate(parentStream->getRate()),
+      _readPos(0), _writePos(0), _filled(0), _parentEnded(parentStream->endOfData()),
+      _decodedSamples(0), _decodeTime(0), _underruns(0) {
+	// Use a power of two for the ring size, which also keeps the positions
+	// of stereo streams on a frame boundary
+	const uint32 samples = aheadMillis * _rate / 1000 * (_isStereo ? 2 : 1);
+	_ringSize = 2 * kPrimeSamples;
+	while (_ringSize < samples)
+		_ringSize <<= 1;
+	_ring = new int16[_ringSize];
+
+	// Have some samples ready for the first read, the timer proc does the rest
+	decode(kPrimeSamples);
+	DecodeAheadWorker::addStream(this);
+}
+
+DecodeAheadAudioStream::~DecodeAheadAudioStream() {
+	debug(1, "DecodeAheadAudioStream: Decoded %d samples in %d ms, %d underruns", _decodedSamples, _decodeTime, _underruns);
+	delete[] _ring;
+}
+
+bool DecodeAheadAudioStream::decodeChunk(uint32 target) {
+	uint32 count;
+	{
+		Common::StackLock lock(_bufferMutex);
+		if (_parentEnded || _filled >= target)
+			return false;
+
+		// Only the free part of the ring is written, which the reader
+		// does not touch, so the decoding itself needs no lock
+		count = MIN<uint32>(_ringSize - _filled, _ringSize - _writePos);
+	}
+
+	const int samples = _parent->readBuffer(_ring + _writePos, MIN<uint32>(count, kDecodeChunk));
+	const bool ended = _parent->endOfData();
+
+	Common::StackLock lock(_bufferMutex);
+	_parentEnded = ended;
+	if (samples <= 0)
+		return false;
+	_writePos = (_writePos + samples) & (_ringSize - 1);
+	_filled += samples;
+	_decodedSamples += samples;
+	return true;
+}
+
+void DecodeAheadAudioStream::decode(uint32 target) {
+	const uint32 start = g_system->getMillis();
+	while (decodeChunk(target))
+		;
+	_decodeTime += g_system->getMillis() - start;
+}
+
+void DecodeAheadAudioStream::fill() {
+	const uint32 start = g_system->getMillis();
+
+	// Only hold the lock for a chunk at a time, so that an underrun in
+	// readBuffer() does not have to wait for a long fill
+	int chunks = 0;
+	while (chunks < kFillChunks) {
+		Common::StackLock lock(_decodeMutex);
+		if (!decodeChunk(_ringSize))
+			break;
+		++chunks;
+	}
+
+	if (chunks) {
+		Common::StackLock lock(_decodeMutex);
+		_decodeTime += g_system->getMillis() - start;
+	}
+}
+
+int DecodeAheadAudioStream::copyOut(int16 *buffer, int numSamples) {
+	// Copying under the lock keeps a concurrent seek from flushing the
+	// samples while they are read
+	Common::StackLock lock(_bufferMutex);
+	int samples = 0;
+	while (samples < numSamples && _filled > 0) {
+		const uint32 count = MIN<uint32>(MIN<uint32>(numSamples - samples, _filled), _ringSize - _readPos);
+		memcpy(buffer + samples, _ring + _readPos, count * sizeof(int16));
+		_readPos = (_readPos + count) & (_ringSize - 1);
+		_filled -= count;
+		samples += count;
+	}
+	return samples;
+}
+
+int DecodeAheadAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = copyOut(buffer, numSamples);
+	if (samples == numSamples)
+		return samples;
+
+	Common::StackLock lock(_decodeMutex);
+
+	// The decoder might have caught up while we waited for it
+	samples += copyOut(buffer + samples, numSamples - samples);
+
+	if (samples < numSamples && !_parentEnded) {
+		// The ring is empty now, so the parent stream is positioned right
+		// after the samples returned so far. Decode the rest directly.
+		++_underruns;
+		debug(1, "DecodeAheadAudioStream: Underrun, decoding %d samples directly", numSamples - samples);
+
+		const uint32 start = g_system->getMillis();
+		const int read = _parent->readBuffer(buffer + samples, numSamples - samples);
+		_decodeTime += g_system->getMillis() - start;
+
+		if (read > 0) {
+			samples += read;
+			_decodedSamples += read;
+		}
+
+		Common::StackLock bufferLock(_bufferMutex);
+		_parentEnded = _parent->endOfData();
+	}
+
+	return samples;
+}
+
+bool DecodeAheadAudioStream::endOfData() const {
+	Common::StackLock lock(_bufferMutex);
+	return _parentEnded && _filled == 0;
+}
+
+bool DecodeAheadAudioStream::seek(const Timestamp &where) {
+	Common::StackLock lock(_decodeMutex);
+	const bool result = _parent->seek(where);
+
+	{
+		Common::StackLock bufferLock(_bufferMutex);
+		_readPos = _writePos = _filled = 0;
+		_parentEnded = _parent->endOfData();
+	}
+
+	// Have some samples ready for the next read, the timer proc does the rest
+	decode(kPrimeSamples);
+	return result;
+}
+
+/**
+ * The stream handed out by makeDecodeAheadStream(). Deleting it does not
+ * wait for the decode ahead timer proc, which matters as the mixer deletes
+ * finished streams while holding its own mutex.
+ */
+class DecodeAheadStreamRef : public SeekableAudioStream {
+public:
+	DecodeAheadStreamRef(DecodeAheadAudioStream *stream) : _stream(stream) {}
+	~DecodeAheadStreamRef() { DecodeAheadWorker::releaseStream(_stream); }
+
+	int readBuffer(int16 *buffer, const int numSamples) { return _stream->readBuffer(buffer, numSamples); }
+	bool endOfData() const { return _stream->endOfData(); }
+	bool isStereo() const { return _stream->isStereo(); }
+	int getRate() const { return _stream->getRate(); }
+
+	bool seek(const Timestamp &where) { return _stream->seek(where); }
+	Timestamp getLength() const { return _stream->getLength(); }
+
+private:
+	DecodeAheadAudioStream *_stream;
+};
+
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parentStream, uint32 aheadMillis, DisposeAfterUse::Flag disposeAfterUse) {
+	return new DecodeAheadStreamRef(new DecodeAheadAudioStream(parentStream, aheadMillis, disposeAfterUse));
+}
+
 /**
  * An AudioStream that plays nothing and immediately returns that
  * the endOfStream() has been reached
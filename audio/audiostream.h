@@ -371,6 +371,25 @@ Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo
  */
 AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp &length, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
+/**
+ * Factory function for a SeekableAudioStream wrapper that decodes its parent
+ * ahead of playback. A timer proc keeps up to the given amount of audio
+ * decoded, so that slow frames or file I/O of compressed streams do not stall
+ * the mixer. Seeking and rewinding flush the audio decoded so far.
+ *
+ * If the decoder falls behind, the missing samples are decoded on the
+ * reading thread like without the wrapper. These underruns and the total
+ * decode time are logged at debug level 1.
+ *
+ * If the timer proc is decoding when the returned stream is destroyed, the
+ * parent stream is disposed of by the timer proc once it is done.
+ *
+ * @param parentStream    The stream to decode ahead
+ * @param aheadMillis     How much audio to keep decoded, in milliseconds
+ * @param disposeAfterUse Whether the parent stream object should be destroyed on destruction of the returned stream
+ */
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parentStream, uint32 aheadMillis, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
 /**
  * An AudioStream designed to work in terms of packets.
  *
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/endian.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -68,20 +69,31 @@ bool ADPCMStream::rewind() {
 
 
 int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
-		}
+	int samples = 0;
+
+	// Finish the byte the previous call stopped in the middle of
+	if (_decodedSampleCount && numSamples > 0) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// Read only the bytes needed, so the stream position stays in step
+	// with the samples returned
+	byte data[256];
+	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+		const uint32 toRead = MIN<uint32>(MIN<uint32>((numSamples - samples + 1) / 2, sizeof(data)), _endpos - _stream->pos());
+		const uint32 count = _stream->read(data, toRead);
+
+		for (uint32 i = 0; i < count; i++) {
+			buffer[samples++] = decodeOKI((data[i] >> 4) & 0x0f);
+			const int16 second = decodeOKI((data[i] >> 0) & 0x0f);
+			if (samples < numSamples) {
+				buffer[samples++] = second;
+			} else {
+				_decodedSamples[1] = second;
+				_decodedSampleCount = 1;
+			}
+		}
 	}
 
 	return samples;
@@ -120,20 +132,32 @@ int16 Oki_ADPCMStream::decodeOKI(byte code) {
 
 
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
-		}
+	int samples = 0;
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// Finish the byte the previous call stopped in the middle of
+	if (_decodedSampleCount && numSamples > 0) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
+
+	// Read only the bytes needed, so the stream position stays in step
+	// with the samples returned
+	const int secondChannel = _channels == 2 ? 1 : 0;
+	byte data[256];
+	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+		const uint32 toRead = MIN<uint32>(MIN<uint32>((numSamples - samples + 1) / 2, sizeof(data)), _endpos - _stream->pos());
+		const uint32 count = _stream->read(data, toRead);
+
+		for (uint32 i = 0; i < count; i++) {
+			buffer[samples++] = decodeIMA((data[i] >> 4) & 0x0f, 0);
+			const int16 second = decodeIMA((data[i] >> 0) & 0x0f, secondChannel);
+			if (samples < numSamples) {
+				buffer[samples++] = second;
+			} else {
+				_decodedSamples[1] = second;
+				_decodedSampleCount = 1;
+			}
+		}
 	}
 
 	return samples;
@@ -142,63 +166,68 @@ int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 #pragma mark -
 
 
-int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	// Need to write at least one samples per channel
-	assert((numSamples % _channels) == 0);
+bool Apple_ADPCMStream::decodeBlock(int channel) {
+	_stream->seek(_streamPos[channel]);
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
 
-	// Current sample positions
-	int samples[2] = { 0, 0};
+	const uint32 size = _stream->read(_block, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	if (size < 2)
+		return false;
 
-	// Number of samples per channel
-	int chanSamples = numSamples / _channels;
+	// 2 byte header per block
+	uint16 temp = READ_BE_UINT16(_block);
 
-	for (int i = 0; i < _channels; i++) {
-		_stream->seek(_streamPos[i]);
-
-		while ((samples[i] < chanSamples) &&
-		       // Last byte read and a new one needed
-		       !((_stream->eos() || (_stream->pos() >= _endpos)) && (_chunkPos[i] == 0))) {
+	// First 9 bits are the upper bits of the predictor
+	_status.ima_ch[channel].last      = (int16) (temp & 0xFF80);
+	// Lower 7 bits are the step index
+	_status.ima_ch[channel].stepIndex =          temp & 0x007F;
 
-			if (_blockPos[i] == _blockAlign) {
-				// 2 byte header per block
-				uint16 temp = _stream->readUint16BE();
+	// Clip the step index
+	_status.ima_ch[channel].stepIndex = CLIP<int32>(_status.ima_ch[channel].stepIndex, 0, 88);
 
-				// First 9 bits are the upper bits of the predictor
-				_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
-				// Lower 7 bits are the step index
-				_status.ima_ch[i].stepIndex =          temp & 0x007F;
+	int16 *samples = _samples[channel];
+	for (uint32 i = 2; i < size; i++) {
+		*samples++ = decodeIMA(_block[i] &  0x0F, channel);
+		*samples++ = decodeIMA(_block[i] >>    4, channel);
+	}
 
-				// Clip the step index
-				_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
+	_sampleIndex[channel] = 0;
+	_samplesLeft[channel] = (size - 2) * 2;
 
-				_blockPos[i] = 2;
-			}
+	// Since the channels are interleaved block-wise, skip the next block
+	if (_channels == 2)
+		_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
 
-			if (_chunkPos[i] == 0) {
-				// Decode data
-				byte data = _stream->readByte();
-				_buffer[i][0] = decodeIMA(data &  0x0F, i);
-				_buffer[i][1] = decodeIMA(data >>    4, i);
-			}
+	_streamPos[channel] = _stream->pos();
+	return true;
+}
 
-			// The original is interleaved block-wise, we want it sample-wise
-			buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
+int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
+	// Need to write at least one samples per channel
+	assert((numSamples % _channels) == 0);
 
-			if (++_chunkPos[i] > 1) {
-				// We're about to decode the next byte, so advance the block position
-				_chunkPos[i] = 0;
-				_blockPos[i]++;
-			}
+	// Current sample positions
+	int samples[2] = { 0, 0};
 
-			samples[i]++;
+	// Number of samples per channel
+	int chanSamples = numSamples / _channels;
 
-			if (_channels == 2)
-				if (_blockPos[i] == _blockAlign)
-					// We're at the end of the block.
-					// Since the channels are interleaved, skip the next block
-					_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	for (int i = 0; i < _channels; i++) {
+		while (samples[i] < chanSamples) {
+			if (_samplesLeft[i] == 0 && !decodeBlock(i))
+				break;
 
-			_streamPos[i] = _stream->pos();
+			// The original is interleaved block-wise, we want it sample-wise
+			const int count = MIN(chanSamples - samples[i], _samplesLeft[i]);
+			const int16 *src = _samples[i] + _sampleIndex[i];
+			int16 *dst = buffer + _channels * samples[i] + i;
+			for (int j = 0; j < count; j++, dst += _channels)
+				*dst = src[j];
+
+			_sampleIndex[i] += count;
+			_samplesLeft[i] -= count;
+			samples[i] += count;
 		}
 	}
 
@@ -209,43 +238,57 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 #pragma mark -
 
 
-int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	// Need to write at least one sample per channel
-	assert((numSamples % _channels) == 0);
-
-	int samples = 0;
+bool MSIma_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
+	const uint32 size = _stream->read(_block, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	if (size < (uint32)_channels * 4)
+		return false;
 
-			_blockPos[0] = _channels * 4;
-		}
+	// read block header
+	const byte *data = _block;
+	for (int i = 0; i < _channels; i++) {
+		_status.ima_ch[i].last = (int16)READ_LE_UINT16(data);
+		_status.ima_ch[i].stepIndex = (int16)READ_LE_UINT16(data + 2);
+		data += 4;
+	}
 
-		// Decode a set of samples
+	// The stream encodes four bytes per channel at a time, eight samples
+	// which are interleaved with those of the other channel
+	const int groups = (size - _channels * 4) / (_channels * 4);
+	int16 *samples = _samples;
+	for (int group = 0; group < groups; group++) {
 		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
 			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
+				samples[(j * 2) * _channels + i] = decodeIMA(data[j] & 0x0f, i);
+				samples[(j * 2 + 1) * _channels + i] = decodeIMA((data[j] >> 4) & 0x0f, i);
 			}
+			data += 4;
 		}
+		samples += 8 * _channels;
+	}
 
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
+	_sampleIndex = 0;
+	_samplesLeft = groups * 8 * _channels;
+	return true;
+}
 
-			samples += _channels;
-		}
+int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
+	// Need to write at least one sample per channel
+	assert((numSamples % _channels) == 0);
+
+	int samples = 0;
+
+	while (samples < numSamples) {
+		if (_samplesLeft == 0 && !decodeBlock())
+			break;
+
+		const int count = MIN(numSamples - samples, _samplesLeft);
+		memcpy(buffer + samples, _samples + _sampleIndex, count * sizeof(int16));
+		_sampleIndex += count;
+		_samplesLeft -= count;
+		samples += count;
 	}
 
 	return samples;
@@ -286,46 +329,60 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 	return (int16)predictor;
 }
 
-int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+bool MS_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
+
+	const uint32 size = _stream->read(_block, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	if (size < (uint32)_channels * 7)
+		return false;
+
+	// read block header
+	const byte *data = _block;
+	int16 *samples = _samples;
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
-				// read block header
-				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-				}
+	for (i = 0; i < _channels; i++) {
+		_status.ch[i].predictor = CLIP(*data++, (byte)0, (byte)6);
+		_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+		_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+	}
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, data += 2)
+		_status.ch[i].delta = (int16)READ_LE_UINT16(data);
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, data += 2)
+		_status.ch[i].sample1 = (int16)READ_LE_UINT16(data);
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, data += 2)
+		*samples++ = _status.ch[i].sample2 = (int16)READ_LE_UINT16(data);
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+	for (i = 0; i < _channels; i++)
+		*samples++ = _status.ch[i].sample1;
 
-				_blockPos[0] = _channels * 7;
-			} else {
-				data = _stream->readByte();
-				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-			}
-			_decodedSampleIndex = 0;
-		}
+	ADPCMChannelStatus *second = &_status.ch[_channels - 1];
+	for (const byte *end = _block + size; data < end; data++) {
+		*samples++ = decodeMS(&_status.ch[0], (*data >> 4) & 0x0f);
+		*samples++ = decodeMS(second, *data & 0x0f);
+	}
+
+	_sampleIndex = 0;
+	_samplesLeft = samples - _samples;
+	return true;
+}
+
+int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = 0;
+
+	while (samples < numSamples) {
+		if (_samplesLeft == 0 && !decodeBlock())
+			break;
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+		const int count = MIN(numSamples - samples, _samplesLeft);
+		memcpy(buffer + samples, _samples + _sampleIndex, count * sizeof(int16));
+		_sampleIndex += count;
+		_samplesLeft -= count;
+		samples += count;
 	}
 
 	return samples;
@@ -341,11 +398,9 @@ do { \
 		_nibble = _lastByte >> 4; \
 		_topNibble = false; \
 	} else { \
-		if (_stream->pos() >= _endpos) \
+		if (_pos >= _dataEnd) \
 			break; \
-		if ((_stream->pos() % _blockAlign) == 0) \
-			continue; \
-		_lastByte = _stream->readByte(); \
+		_lastByte = _block[_pos++ % _blockAlign]; \
 		_nibble = _lastByte & 0xf; \
 		_topNibble = true; \
 	} \
@@ -357,20 +412,34 @@ int DK3_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 
 	assert((numSamples % 4) == 0);
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if ((_stream->pos() % _blockAlign) == 0) {
-			_stream->readUint16LE(); // Unknown
-			uint16 rate = _stream->readUint16LE(); // Copy of rate
-			_stream->skip(6); // Unknown
-			// Get predictor for both sum/diff channels
-			_status.ima_ch[0].last = _stream->readSint16LE();
-			_status.ima_ch[1].last = _stream->readSint16LE();
-			// Get index for both sum/diff channels
-			_status.ima_ch[0].stepIndex = _stream->readByte();
-			_status.ima_ch[1].stepIndex = _stream->readByte();
+	while (samples < numSamples) {
+		if (_pos >= _dataEnd) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
 
-			if (_stream->eos())
+			// Read up to the next block boundary. No nibble is ever read
+			// across one, instead the last one is used again.
+			const uint32 size = MIN<uint32>(_blockAlign - _pos % _blockAlign, _endpos - _pos);
+			_dataEnd = _pos + _stream->read(_block + _pos % _blockAlign, size);
+			if (_dataEnd == _pos)
 				break;
+		}
+
+		if ((_pos % _blockAlign) == 0) {
+			if (_dataEnd - _pos < 16) {
+				_pos = _dataEnd;
+				break;
+			}
+
+			const byte *header = _block;
+			uint16 rate = READ_LE_UINT16(header + 2); // Copy of rate
+			// Get predictor for both sum/diff channels
+			_status.ima_ch[0].last = (int16)READ_LE_UINT16(header + 10);
+			_status.ima_ch[1].last = (int16)READ_LE_UINT16(header + 12);
+			// Get index for both sum/diff channels
+			_status.ima_ch[0].stepIndex = header[14];
+			_status.ima_ch[1].stepIndex = header[15];
+			_pos += 16;
 
 			// Sanity check
 			assert(rate == getRate());
@@ -129,26 +129,45 @@ class Apple_ADPCMStream : public Ima_ADPCMStream {
 protected:
 	// Apple QuickTime IMA ADPCM
 	int32 _streamPos[2];
-	int16 _buffer[2][2];
-	uint8 _chunkPos[2];
+	int16 *_samples[2];
+	int _sampleIndex[2];
+	int _samplesLeft[2];
+	byte *_block;
 
 	void reset() {
 		Ima_ADPCMStream::reset();
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
 		_streamPos[0] = 0;
 		_streamPos[1] = _blockAlign;
+		_samplesLeft[0] = 0;
+		_samplesLeft[1] = 0;
 	}
 
+	/**
+	 * Decode the next block of the given channel, returning false at the
+	 * end of the stream.
+	 */
+	bool decodeBlock(int channel);
+
 public:
 	Apple_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
+		_block = new byte[_blockAlign];
+		_samples[0] = new int16[_blockAlign * 2];
+		_samples[1] = new int16[_blockAlign * 2];
 		_streamPos[0] = 0;
 		_streamPos[1] = _blockAlign;
+		_samplesLeft[0] = 0;
+		_samplesLeft[1] = 0;
 	}
 
+	~Apple_ADPCMStream() {
+		delete[] _block;
+		delete[] _samples[0];
+		delete[] _samples[1];
+	}
+
+	virtual bool endOfData() const { return (_stream->eos() || _streamPos[0] >= _endpos) && (_samplesLeft[0] == 0); }
+
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 };
@@ -164,21 +183,36 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		_block = new byte[_blockAlign];
+		_samples = new int16[_blockAlign * 2];
+		_sampleIndex = 0;
+		_samplesLeft = 0;
 	}
 
+	~MSIma_ADPCMStream() {
+		delete[] _block;
+		delete[] _samples;
+	}
+
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_samplesLeft == 0); }
+
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 	void reset() {
 		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		_samplesLeft = 0;
 	}
 
 private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+	/**
+	 * Decode the next block, returning false at the end of the stream.
+	 */
+	bool decodeBlock();
+
+	byte *_block;
+	int16 *_samples;
+	int _sampleIndex;
+	int _samplesLeft;
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -200,6 +234,7 @@ protected:
 	void reset() {
 		ADPCMStream::reset();
 		memset(&_status, 0, sizeof(_status));
+		_samplesLeft = 0;
 	}
 
 public:
@@ -208,21 +243,34 @@ public:
 		if (blockAlign == 0)
 			error("MS_ADPCMStream(): blockAlign isn't specified for MS ADPCM");
 		memset(&_status, 0, sizeof(_status));
-		_decodedSampleCount = 0;
-		_decodedSampleIndex = 0;
+		_block = new byte[_blockAlign];
+		_samples = new int16[_blockAlign * 2 + 4];
+		_sampleIndex = 0;
+		_samplesLeft = 0;
 	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	~MS_ADPCMStream() {
+		delete[] _block;
+		delete[] _samples;
+	}
+
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_samplesLeft == 0); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
 
+	/**
+	 * Decode the next block, returning false at the end of the stream.
+	 */
+	bool decodeBlock();
+
 private:
-	uint8 _decodedSampleCount;
-	uint8 _decodedSampleIndex;
-	int16 _decodedSamples[4];
+	byte *_block;
+	int16 *_samples;
+	int _sampleIndex;
+	int _samplesLeft;
 };
 
 // Duck DK3 IMA ADPCM Decoder
@@ -234,6 +282,7 @@ protected:
 	void reset() {
 		Ima_ADPCMStream::reset();
 		_topNibble = false;
+		_pos = _dataEnd = _startpos;
 	}
 
 public:
@@ -243,13 +292,26 @@ public:
 		// DK3 only works as a stereo stream
 		assert(channels == 2);
 		_topNibble = false;
+		_block = new byte[_blockAlign];
+		_pos = _dataEnd = _startpos;
 	}
 
+	~DK3_ADPCMStream() {
+		delete[] _block;
+	}
+
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_pos >= _dataEnd); }
+
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 private:
 	byte _nibble, _lastByte;
 	bool _topNibble;
+
+	// The data up to the next block boundary is read at once. _pos is the
+	// stream position decoding is at, _dataEnd the position read up to.
+	byte *_block;
+	int32 _pos, _dataEnd;
 };
 
 } // End of namespace Audio
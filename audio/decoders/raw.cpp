@@ -20,6 +20,14 @@
  *
  */
 
+// The sample conversion uses SSE2 when the compiler targets it, which it
+// always does for x86-64. <emmintrin.h> pulls in system headers, so it
+// has to come first.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAW_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "common/endian.h"
 #include "common/memstream.h"
 #include "common/textconsole.h"
@@ -38,6 +46,42 @@ namespace Audio {
 #define READ_ENDIAN_SAMPLE(is16Bit, isUnsigned, ptr, isLE) \
 	((is16Bit ? (isLE ? READ_LE_UINT16(ptr) : READ_BE_UINT16(ptr)) : (*ptr << 8)) ^ (isUnsigned ? 0x8000 : 0))
 
+/**
+ * Converts raw samples into native endian signed 16 bit samples.
+ *
+ * @param src   The raw sample data, which needs no particular alignment.
+ * @param dst   Buffer for the converted samples.
+ * @param count Number of samples to convert.
+ */
+template<bool is16Bit, bool isUnsigned, bool isLE>
+static void convertSamples(const byte *src, int16 *dst, int count) {
+#ifdef RAW_SSE2
+	// Eight samples at a time. SSE2 implies a little endian host, so big
+	// endian samples get their bytes swapped, while 8 bit samples are
+	// interleaved with zero bytes to end up in the upper half.
+	const __m128i flip = _mm_set1_epi16(isUnsigned ? (int16)0x8000 : 0);
+	for (; count >= 8; count -= 8) {
+		__m128i v;
+		if (is16Bit) {
+			v = _mm_loadu_si128((const __m128i *)src);
+			if (!isLE)
+				v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			src += 16;
+		} else {
+			v = _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i *)src));
+			src += 8;
+		}
+		_mm_storeu_si128((__m128i *)dst, _mm_xor_si128(v, flip));
+		dst += 8;
+	}
+#endif
+
+	while (count-- > 0) {
+		*dst++ = READ_ENDIAN_SAMPLE(is16Bit, isUnsigned, src, isLE);
+		src += (is16Bit ? 2 : 1);
+	}
+}
+
 
 #pragma mark -
 #pragma mark --- RawStream ---
@@ -45,15 +89,21 @@ namespace Audio {
 
 /**
  * This is a stream, which allows for playing raw PCM data from a stream.
+ *
+ * When the stream keeps its data in memory, the samples are converted
+ * straight from there, without reading them into a buffer first.
  */
 template<bool is16Bit, bool isUnsigned, bool isLE>
 class RawStream : public SeekableAudioStream {
 public:
 	RawStream(int rate, bool stereo, DisposeAfterUse::Flag disposeStream, Common::SeekableReadStream *stream)
-		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _buffer(0) {
+		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false),
+		  _memory(stream->getMemory()), _buffer(0) {
 		// Setup our buffer for readBuffer
-		_buffer = new byte[kSampleBufferLength * (is16Bit ? 2 : 1)];
-		assert(_buffer);
+		if (!_memory) {
+			_buffer = new byte[kSampleBufferLength * (is16Bit ? 2 : 1)];
+			assert(_buffer);
+		}
 
 		// Calculate the total playtime of the stream
 		_playtime = Timestamp(0, _stream->size() / (_isStereo ? 2 : 1) / (is16Bit ? 2 : 1), rate);
@@ -78,6 +128,7 @@ private:
 	Timestamp _playtime;                                       ///< Calculated total play time
 	Common::DisposablePtr<Common::SeekableReadStream> _stream; ///< Stream to read data from
 	bool _endOfData;                                           ///< Whether the stream end has been reached
+	const byte *_memory;                                       ///< Data of the stream, if it is held in memory
 
 	byte *_buffer;                                             ///< Buffer used in readBuffer
 	enum {
@@ -97,10 +148,22 @@ private:
 	 * @return actual count of samples read.
 	 */
 	int fillBuffer(int maxSamples);
+
+	/**
+	 * Converts samples straight from the memory of the stream.
+	 *
+	 * @param buffer     Buffer for the converted samples.
+	 * @param numSamples Maximum samples to convert.
+	 * @return actual count of samples converted.
+	 */
+	int readFromMemory(int16 *buffer, const int numSamples);
 };
 
 template<bool is16Bit, bool isUnsigned, bool isLE>
 int RawStream<is16Bit, isUnsigned, isLE>::readBuffer(int16 *buffer, const int numSamples) {
+	if (_memory)
+		return readFromMemory(buffer, numSamples);
+
 	int samplesLeft = numSamples;
 
 	while (samplesLeft > 0) {
@@ -116,16 +179,31 @@ int RawStream<is16Bit, isUnsigned, isLE>::readBuffer(int16 *buffer, const int nu
 		samplesLeft -= len;
 
 		// Copy the data to the caller's buffer.
-		const byte *src = _buffer;
-		while (len-- > 0) {
-			*buffer++ = READ_ENDIAN_SAMPLE(is16Bit, isUnsigned, src, isLE);
-			src += (is16Bit ? 2 : 1);
-		}
+		convertSamples<is16Bit, isUnsigned, isLE>(_buffer, buffer, len);
+		buffer += len;
 	}
 
 	return numSamples - samplesLeft;
 }
 
+template<bool is16Bit, bool isUnsigned, bool isLE>
+int RawStream<is16Bit, isUnsigned, isLE>::readFromMemory(int16 *buffer, const int numSamples) {
+	if (endOfData())
+		return 0;
+
+	const int32 pos = _stream->pos();
+	const int samples = MIN<int32>(numSamples, (_stream->size() - pos) / (is16Bit ? 2 : 1));
+	convertSamples<is16Bit, isUnsigned, isLE>(_memory + pos, buffer, samples);
+
+	// Keep the stream position up to date, seek() relies on it
+	_stream->seek(samples * (is16Bit ? 2 : 1), SEEK_CUR);
+	// A trailing byte, which is not a whole sample, is never read
+	if (_stream->size() - _stream->pos() < (is16Bit ? 2 : 1))
+		_endOfData = true;
+
+	return samples;
+}
+
 template<bool is16Bit, bool isUnsigned, bool isLE>
 int RawStream<is16Bit, isUnsigned, isLE>::fillBuffer(int maxSamples) {
 	int bufferedSamples = 0;
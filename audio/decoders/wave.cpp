@@ -23,6 +23,7 @@
 #include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/substream.h"
 
 #include "audio/audiostream.h"
 #include "audio/decoders/wave.h"
@@ -208,6 +209,12 @@ SeekableAudioStream *makeWAVStream(Common::SeekableReadStream *stream, DisposeAf
 		size &= ~(sampleSize - 1);
 	}
 
+	// Raw PCM held in memory is played from there, as long as we get to
+	// keep the stream
+	const int32 pos = stream->pos();
+	if (stream->getMemory() && disposeAfterUse == DisposeAfterUse::YES && size <= stream->size() - pos)
+		return makeRawStream(new Common::SeekableSubReadStream(stream, pos, pos + size, DisposeAfterUse::YES), rate, flags);
+
 	// Raw PCM. Just read everything at once.
 	// TODO: More elegant would be to wrap the stream.
 	byte *data = (byte *)malloc(size);
@@ -260,10 +260,14 @@ void RealOPL::onTimer() {
 			(*_callback)();
 }
 
-EmulatedOPL::EmulatedOPL() :
+EmulatedOPL::EmulatedOPL(bool queueWrites) :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
+	_queueWrites(queueWrites),
+	_position(0),
+	_writePosition(0),
+	_streamRunning(false),
 	_handle(new Audio::SoundHandle()) {
 }
 
@@ -278,6 +282,9 @@ EmulatedOPL::~EmulatedOPL() {
 }
 
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
+	if (_queueWrites)
+		return readBufferQueued(buffer, numSamples);
+
 	const int stereoFactor = isStereo() ? 2 : 1;
 	int len = numSamples / stereoFactor;
 	int step;
@@ -304,17 +311,113 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	return numSamples;
 }
 
+int EmulatedOPL::readBufferQueued(int16 *buffer, const int numSamples) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	const uint32 start = _position;
+	const uint32 end = start + numSamples / stereoFactor;
+
+	// Run the callbacks for every tick in this buffer. Nothing has been
+	// rendered yet, their writes are queued with the position of the tick.
+	uint32 pos = start;
+	do {
+		int step = end - pos;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		pos += step;
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			_writeMutex.lock();
+			_writePosition = pos;
+			_writeMutex.unlock();
+
+			if (_callback && _callback->isValid())
+				(*_callback)();
+
+			_nextTick += _samplesPerTick;
+		}
+	} while (pos != end);
+
+	// Render up to each write in turn. Writes are queued in order, so
+	// this needs only one pass.
+	Common::StackLock lock(_writeMutex);
+
+	uint i = 0;
+	pos = start;
+	while (pos != end) {
+		for (; i < _writes.size() && (int32)(_writes[i].timestamp - pos) <= 0; ++i)
+			applyWrite(_writes[i].reg, _writes[i].value);
+
+		uint32 next = end;
+		if (i < _writes.size() && (int32)(_writes[i].timestamp - end) < 0)
+			next = _writes[i].timestamp;
+
+		generateSamples(buffer, (next - pos) * stereoFactor);
+		buffer += (next - pos) * stereoFactor;
+		pos = next;
+	}
+
+	// Writes at the very end of the buffer are left for the next one
+	uint left = 0;
+	for (; i < _writes.size(); ++i)
+		_writes[left++] = _writes[i];
+	_writes.resize(left);
+
+	_position = end;
+	_writePosition = end;
+
+	return numSamples;
+}
+
+void EmulatedOPL::queueWrite(uint reg, uint8 value) {
+	Common::StackLock lock(_writeMutex);
+
+	// Nothing renders the queue while the stream is stopped, or while it
+	// isn't read, e.g. when the mixer is paused. No samples are rendered
+	// between the writes then, so applying them in order is enough.
+	if (!_streamRunning || _writes.size() >= kMaxQueuedWrites) {
+		applyQueuedWrites();
+		applyWrite(reg, value);
+		return;
+	}
+
+	RegisterWrite write;
+	write.timestamp = _writePosition;
+	write.reg = reg;
+	write.value = value;
+	_writes.push_back(write);
+}
+
+void EmulatedOPL::clearWrites() {
+	Common::StackLock lock(_writeMutex);
+	_writes.resize(0);
+}
+
+void EmulatedOPL::applyQueuedWrites() {
+	for (uint i = 0; i < _writes.size(); ++i)
+		applyWrite(_writes[i].reg, _writes[i].value);
+	_writes.resize(0);
+}
+
 int EmulatedOPL::getRate() const {
 	return g_system->getMixer()->getOutputRate();
 }
 
 void EmulatedOPL::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
+
+	_writeMutex.lock();
+	_streamRunning = true;
+	_writeMutex.unlock();
+
 	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 }
 
 void EmulatedOPL::stopCallbacks() {
 	g_system->getMixer()->stopHandle(*_handle);
+
+	Common::StackLock lock(_writeMutex);
+	_streamRunning = false;
 }
 
 void EmulatedOPL::setCallbackFrequency(int timerFrequency) {
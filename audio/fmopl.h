@@ -25,7 +25,9 @@
 
 #include "audio/audiostream.h"
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -239,7 +241,11 @@ private:
  */
 class EmulatedOPL : public OPL, protected Audio::AudioStream {
 public:
-	EmulatedOPL();
+	/**
+	 * @param queueWrites	whether the emulator routes all writes to the
+	 *                      emulated chip through queueWrite()
+	 */
+	EmulatedOPL(bool queueWrites = false);
 	virtual ~EmulatedOPL();
 
 	// OPL API
@@ -267,6 +273,33 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Queue a write to a register of the emulated chip. It is passed to
+	 * applyWrite() once rendering reaches the sample position it was
+	 * issued at: the current tick for writes from the callback, the first
+	 * sample not rendered yet for writes from any other thread.
+	 *
+	 * This lets readBuffer() run the callbacks for a whole buffer first
+	 * and then render it in one generateSamples() call per group of
+	 * writes, instead of one call per tick.
+	 *
+	 * While the stream is stopped, or once kMaxQueuedWrites writes are
+	 * waiting for a stream that isn't read, the queue is applied right
+	 * away instead.
+	 */
+	void queueWrite(uint reg, uint8 value);
+
+	/**
+	 * Drop all writes not applied yet, e.g. when the chip is reset.
+	 */
+	void clearWrites();
+
+	/**
+	 * Write to a register of the emulated chip. Only called from
+	 * readBuffer() by emulators which queue their writes.
+	 */
+	virtual void applyWrite(uint reg, uint8 value) {}
+
 private:
 	int _baseFreq;
 
@@ -277,6 +310,26 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	struct RegisterWrite {
+		uint32 timestamp;
+		uint16 reg;
+		uint8 value;
+	};
+
+	enum {
+		kMaxQueuedWrites = 16384
+	};
+
+	const bool _queueWrites;
+	Common::Mutex _writeMutex;
+	Common::Array<RegisterWrite> _writes;
+	uint32 _position;
+	uint32 _writePosition;
+	bool _streamRunning;
+
+	int readBufferQueued(int16 *buffer, const int numSamples);
+	void applyQueuedWrites();
+
 	Audio::SoundHandle *_handle;
 };
 
@@ -29,6 +29,10 @@
 
 class MidiChannel;
 
+namespace Audio {
+class MusicRecorder;
+}
+
 /**
  * Music types that music drivers can implement and engines can rely on.
  */
@@ -107,6 +111,17 @@ public:
 		send(status | ((uint32)firstOp << 8) | ((uint32)secondOp << 16));
 	}
 
+	/**
+	 * Output several packed midi commands, in the given order. The default
+	 * implementation calls send() for each of them. Drivers which pay a
+	 * fixed cost for each send(), like taking a lock or a system call,
+	 * override this to pay it only once for all of them.
+	 */
+	virtual void sendBatch(const uint32 *events, uint count) {
+		for (uint i = 0; i < count; ++i)
+			send(events[i]);
+	}
+
 	/**
 	 * Transmit a sysEx to the midi device.
 	 *
@@ -241,6 +256,14 @@ public:
 
 	virtual void sysEx_customInstrument(byte channel, uint32 type, const byte *instr) { }
 
+	/**
+	 * Attach a recorder, which is passed everything the driver outputs from
+	 * now on, or detach it again by passing 0. Used by the music cache.
+	 * @return false if the driver cannot record its output, as for drivers
+	 * of real MIDI devices
+	 */
+	virtual bool setRecorder(Audio::MusicRecorder *recorder) { return false; }
+
 	// Timing functions - MidiDriver now operates timers
 	virtual void setTimerCallback(void *timer_param, Common::TimerManager::TimerProc timer_proc) = 0;
 
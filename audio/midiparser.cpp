@@ -22,6 +22,7 @@
 
 #include "audio/midiparser.h"
 #include "audio/mididrv.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -45,8 +46,14 @@ _sendSustainOffOnNotesOff(false),
 _numTracks(0),
 _activeTrack(255),
 _abortParse(false),
-_jumpingToTick(false) {
+_jumpingToTick(false),
+_indexedJumps(false),
+_checkpointTrack(255),
+_trackTempo(0),
+_batching(false),
+_batchSize(0) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
+	memset(_batchHistogram, 0, sizeof(_batchHistogram));
 	memset(_tracks, 0, sizeof(_tracks));
 	_nextEvent.start = NULL;
 	_nextEvent.delta = 0;
@@ -68,11 +75,55 @@ void MidiParser::property(int prop, int value) {
 	case mpSendSustainOffOnNotesOff:
 		_sendSustainOffOnNotesOff = (value != 0);
 		break;
+	case mpIndexedJumps:
+		_indexedJumps = (value != 0);
+		if (!_indexedJumps)
+			_checkpoints.clear();
+		break;
 	}
 }
 
 void MidiParser::sendToDriver(uint32 b) {
+	if (_batching) {
+		_batch[_batchSize++] = b;
+		if (_batchSize == kBatchSize)
+			flushBatch();
+		return;
+	}
+
 	_driver->send(b);
+	countDriverCall(1);
+}
+
+bool MidiParser::beginBatch() {
+	const bool wasBatching = _batching;
+	_batching = true;
+	return wasBatching;
+}
+
+void MidiParser::endBatch() {
+	_batching = false;
+	flushBatch();
+}
+
+void MidiParser::flushBatch() {
+	if (!_batchSize)
+		return;
+
+	const uint count = _batchSize;
+	_batchSize = 0;
+	if (count == 1)
+		_driver->send(_batch[0]);
+	else
+		_driver->sendBatch(_batch, count);
+	countDriverCall(count);
+}
+
+void MidiParser::countDriverCall(uint events) {
+	int bucket = 0;
+	while (bucket < kBatchHistogramSize - 1 && events > (1u << bucket))
+		++bucket;
+	++_batchHistogram[bucket];
 }
 
 void MidiParser::setTempo(uint32 tempo) {
@@ -172,6 +223,10 @@ void MidiParser::onTimer() {
 	_abortParse = false;
 	endTime = _position._playTime + _timerRate;
 
+	// Events due in this call are sent together, as they are heard
+	// together anyway
+	beginBatch();
+
 	// Scan our hanging notes for any
 	// that should be turned off.
 	if (_hangingNotesCount) {
@@ -202,6 +257,7 @@ void MidiParser::onTimer() {
 		if (info.event < 0x80) {
 			warning("Bad command or running status %02X", info.event);
 			_position._playPos = 0;
+			endBatch();
 			return;
 		}
 
@@ -214,18 +270,28 @@ void MidiParser::onTimer() {
 				activeNote(info.channel(), info.basic.param1, true);
 		}
 
+		// SysEx and meta events may call back into the client, which
+		// expects the events before them to have been sent
+		if (info.event >= 0xF0)
+			endBatch();
+
 		// Player::metaEvent() in SCUMM will delete the parser object,
 		// so return immediately if that might have happened.
 		bool ret = processEvent(info);
 		if (!ret)
 			return;
 
+		beginBatch();
+
 		if (!_abortParse) {
 			_position._lastEventTime = eventTime;
 			parseNextEvent(_nextEvent);
+			addCheckpoint();
 		}
 	}
 
+	endBatch();
+
 	if (!_abortParse) {
 		_position._playTime = endTime;
 		_position._playTick = (_position._playTime - _position._lastEventTime) / _psecPerTick + _position._lastEventTick;
@@ -258,7 +324,8 @@ bool MidiParser::processEvent(const EventInfo &info, bool fireEvents) {
 			return false;
 		} else if (info.ext.type == 0x51) {
 			if (info.length >= 3) {
-				setTempo(info.ext.data[0] << 16 | info.ext.data[1] << 8 | info.ext.data[2]);
+				_trackTempo = info.ext.data[0] << 16 | info.ext.data[1] << 8 | info.ext.data[2];
+				setTempo(_trackTempo);
 			}
 		}
 		if (fireEvents)
@@ -276,6 +343,7 @@ void MidiParser::allNotesOff() {
 	if (!_driver)
 		return;
 
+	const bool wasBatching = beginBatch();
 	int i, j;
 
 	// Turn off all active notes
@@ -306,10 +374,65 @@ void MidiParser::allNotesOff() {
 	}
 
 	memset(_activeNotes, 0, sizeof(_activeNotes));
+
+	if (!wasBatching)
+		endBatch();
 }
 
 void MidiParser::resetTracking() {
 	_position.clear();
+	_trackTempo = 0;
+}
+
+void MidiParser::addCheckpoint() {
+	if (!_indexedJumps || !isCheckpointSafe())
+		return;
+
+	if (_checkpointTrack != _activeTrack) {
+		_checkpoints.clear();
+		_checkpointTrack = _activeTrack;
+	}
+
+	// Take a checkpoint about every bar, only extending the index
+	const uint32 lastTick = _checkpoints.empty() ? 0 : _checkpoints.back().position._lastEventTick;
+	if (_position._lastEventTick < lastTick + MAX<uint32>(_ppqn * 4, 1))
+		return;
+
+	Checkpoint checkpoint;
+	checkpoint.position = _position;
+	checkpoint.event = _nextEvent;
+	checkpoint.trackTempo = _trackTempo;
+	_checkpoints.push_back(checkpoint);
+}
+
+void MidiParser::restoreCheckpoint(uint32 tick) {
+	if (!_indexedJumps || _checkpointTrack != _activeTrack)
+		return;
+
+	// Find the last checkpoint before the tick, which a replay from the
+	// start would pass through
+	uint first = 0, last = _checkpoints.size();
+	while (first < last) {
+		const uint middle = (first + last) / 2;
+		if (_checkpoints[middle].position._lastEventTick < tick)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	if (!first)
+		return;
+
+	// Only the times relative to the last event matter, so the timing of
+	// the checkpoint does not depend on the tempo it was taken with. The
+	// replay keeps the current tempo until the track sets one.
+	const Checkpoint &checkpoint = _checkpoints[first - 1];
+	_position = checkpoint.position;
+	_position._playTick = _position._lastEventTick;
+	_position._playTime = _position._lastEventTime;
+	_nextEvent = checkpoint.event;
+	_trackTempo = checkpoint.trackTempo;
+	if (_trackTempo)
+		setTempo(_trackTempo);
 }
 
 bool MidiParser::setTrack(int track) {
@@ -392,11 +515,21 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 
 	Tracker currentPos(_position);
 	EventInfo currentEvent(_nextEvent);
+	const uint32 currentTrackTempo = _trackTempo;
+
+	// Jumps replay a burst of controller and program changes, which are
+	// sent together
+	const bool wasBatching = beginBatch();
 
 	resetTracking();
 	_position._playPos = _tracks[_activeTrack];
 	parseNextEvent(_nextEvent);
 	if (tick > 0) {
+		// Fired events cannot be skipped, so only continue from a
+		// checkpoint when they are not
+		if (!fireEvents)
+			restoreCheckpoint(tick);
+
 		while (true) {
 			EventInfo &info = _nextEvent;
 			if (_position._lastEventTick + info.delta >= tick) {
@@ -419,13 +552,19 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				// This means that we failed to find the right tick.
 				_position = currentPos;
 				_nextEvent = currentEvent;
+				_trackTempo = currentTrackTempo;
 				_jumpingToTick = false;
+				if (!wasBatching)
+					endBatch();
 				return false;
 			} else {
+				if (info.event >= 0xF0)
+					flushBatch();
 				processEvent(info, fireEvents);
 			}
 
 			parseNextEvent(_nextEvent);
+			addCheckpoint();
 		}
 	}
 
@@ -445,13 +584,27 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 		}
 	}
 
+	if (!wasBatching)
+		endBatch();
+
 	_abortParse = true;
 	_jumpingToTick = false;
 	return true;
 }
 
 void MidiParser::unloadMusic() {
+	uint32 driverCalls = 0;
+	for (int i = 0; i < kBatchHistogramSize; ++i)
+		driverCalls += _batchHistogram[i];
+	if (driverCalls) {
+		debug(1, "MidiParser: Driver calls by events sent: 1: %u, 2: %u, 3-4: %u, 5-8: %u, 9-16: %u, 17-32: %u, 33-64: %u",
+		      _batchHistogram[0], _batchHistogram[1], _batchHistogram[2], _batchHistogram[3],
+		      _batchHistogram[4], _batchHistogram[5], _batchHistogram[6]);
+		memset(_batchHistogram, 0, sizeof(_batchHistogram));
+	}
+
 	resetTracking();
+	_checkpoints.clear();
 	allNotesOff();
 	_numTracks = 0;
 	_activeTrack = 255;
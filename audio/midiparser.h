@@ -26,6 +26,7 @@
 #define AUDIO_MIDIPARSER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/endian.h"
 
 class MidiDriver_BASE;
@@ -289,6 +290,31 @@ protected:
 	bool   _abortParse;    ///< If a jump or other operation interrupts parsing, flag to abort.
 	bool   _jumpingToTick; ///< True if currently inside jumpToTick
 
+	/**
+	 * The parser state right after an event, from which jumpToTick() can
+	 * continue instead of replaying the track from its start.
+	 */
+	struct Checkpoint {
+		Tracker position;   ///< The position after the event
+		EventInfo event;    ///< The pre-parsed next event
+		uint32 trackTempo;  ///< The tempo last set by the track, 0 if none
+	};
+
+	bool   _indexedJumps;  ///< Whether to keep checkpoints for jumpToTick()
+	Common::Array<Checkpoint> _checkpoints; ///< Checkpoints of one track, ordered by tick
+	byte   _checkpointTrack; ///< The track the checkpoints belong to
+	uint32 _trackTempo;    ///< The tempo last set by the track, 0 if none
+
+	enum {
+		kBatchSize = 64,
+		kBatchHistogramSize = 7  ///< Buckets for 1, 2, 3-4, ..., 33-64 events per driver call
+	};
+
+	bool   _batching;      ///< Whether sendToDriver() collects events in _batch
+	uint32 _batch[kBatchSize]; ///< Channel events not yet sent to the driver
+	uint   _batchSize;     ///< Number of events in _batch
+	uint32 _batchHistogram[kBatchHistogramSize]; ///< Driver calls by number of events sent
+
 protected:
 	static uint32 readVLQ(byte * &data);
 	virtual void resetTracking();
@@ -296,6 +322,15 @@ protected:
 	virtual void parseNextEvent(EventInfo &info) = 0;
 	virtual bool processEvent(const EventInfo &info, bool fireEvents = true);
 
+	/**
+	 * Whether the parser state is completely described by _position and
+	 * _nextEvent, so that a checkpoint can be taken. Parsers that keep
+	 * additional state, e.g. about loops, return false while it is in use.
+	 */
+	virtual bool isCheckpointSafe() const { return true; }
+	void addCheckpoint();
+	void restoreCheckpoint(uint32 tick);
+
 	void activeNote(byte channel, byte note, bool active);
 	void hangingNote(byte channel, byte note, uint32 ticksLeft, bool recycle = true);
 	void hangAllActiveNotes();
@@ -305,6 +340,18 @@ protected:
 		sendToDriver(status | ((uint32)firstOp << 8) | ((uint32)secondOp << 16));
 	}
 
+	/**
+	 * Collect the channel events passed to sendToDriver() from now on,
+	 * and send them to the driver with a single sendBatch() call. Events
+	 * which may call back into the client, like SysEx and meta events,
+	 * must only be sent after endBatch().
+	 * @return whether events were already being collected
+	 */
+	bool beginBatch();
+	void endBatch();
+	void flushBatch();
+	void countDriverCall(uint events);
+
 	/**
 	 * Platform independent BE uint32 read-and-advance.
 	 * This helper function reads Big Endian 32-bit numbers
@@ -365,7 +412,17 @@ public:
 		 * Sends a sustain off event when a notes off event is triggered.
 		 * Stops hanging notes.
 		 */
-		 mpSendSustainOffOnNotesOff = 5
+		 mpSendSustainOffOnNotesOff = 5,
+
+		/**
+		 * Keep an index of checkpoints of the active track, built while
+		 * playing and jumping. Jumps that do not fire events then only
+		 * replay the events after the nearest checkpoint instead of the
+		 * whole track. Only enable this if parsing and processing events
+		 * has no side effects beyond the parser state, e.g. no XMIDI
+		 * callbacks or engine specific processEvent() handling.
+		 */
+		mpIndexedJumps = 6
 	};
 
 public:
@@ -68,6 +68,9 @@ protected:
 		_loopCount = -1;
 	}
 
+	// The loop stack is not part of a checkpoint
+	virtual bool isCheckpointSafe() const { return _loopCount < 0; }
+
 public:
 	MidiParser_XMIDI(XMidiCallbackProc proc, void *data, XMidiNewTimbreListProc newTimbreListProc, MidiDriver_BASE *newTimbreListDriver) {
 		_callbackProc = proc;
@@ -22,8 +22,11 @@
 
 #include "audio/midiplayer.h"
 #include "audio/midiparser.h"
+#include "audio/audiostream.h"
+#include "audio/musiccache.h"
 
 #include "common/config-manager.h"
+#include "common/system.h"
 
 namespace Audio {
 
@@ -34,7 +37,11 @@ MidiPlayer::MidiPlayer() :
 	_isLooping(false),
 	_isPlaying(false),
 	_masterVolume(0),
-	_nativeMT32(false) {
+	_nativeMT32(false),
+	_device(0),
+	_recorder(0),
+	_playingCached(false),
+	_cachedVolume(0) {
 
 	memset(_channelsTable, 0, sizeof(_channelsTable));
 	memset(_channelsVolume, 127, sizeof(_channelsVolume));
@@ -48,6 +55,7 @@ MidiPlayer::~MidiPlayer() {
 	// Hopefully, this make no real difference, but we should
 	// watch out for regressions.
 	stop();
+	MusicRecorder::saveQueued();
 
 	// Unhook & unload the driver
 	if (_driver) {
@@ -61,6 +69,7 @@ MidiPlayer::~MidiPlayer() {
 void MidiPlayer::createDriver(int flags) {
 	MidiDriver::DeviceHandle dev = MidiDriver::detectDevice(flags);
 	_nativeMT32 = ((MidiDriver::getMusicType(dev) == MT_MT32) || ConfMan.getBool("native_mt32"));
+	_device = dev;
 
 	_driver = MidiDriver::createMidi(dev);
 	assert(_driver);
@@ -74,14 +83,30 @@ void MidiPlayer::setVolume(int volume) {
 	if (_masterVolume == volume)
 		return;
 
-	Common::StackLock lock(_mutex);
+	bool playingCached;
+	int cacheVolume = 0;
+	{
+		Common::StackLock lock(_mutex);
 
-	_masterVolume = volume;
-	for (int i = 0; i < kNumChannels; ++i) {
-		if (_channelsTable[i]) {
-			_channelsTable[i]->volume(_channelsVolume[i] * _masterVolume / 255);
+		_masterVolume = volume;
+		for (int i = 0; i < kNumChannels; ++i) {
+			if (_channelsTable[i]) {
+				_channelsTable[i]->volume(_channelsVolume[i] * _masterVolume / 255);
+			}
 		}
+
+		// The recording would mix both volumes
+		stopRecording(false);
+
+		// Cached songs can only be made quieter than they were recorded at
+		playingCached = _playingCached;
+		if (playingCached)
+			cacheVolume = MIN(_masterVolume * Mixer::kMaxChannelVolume / _cachedVolume, (int)Mixer::kMaxChannelVolume);
 	}
+
+	// The mixer is called without holding _mutex, see onTimer()
+	if (playingCached)
+		g_system->getMixer()->setChannelVolume(_cacheHandle, cacheVolume);
 }
 
 void MidiPlayer::syncVolume() {
@@ -134,7 +159,89 @@ void MidiPlayer::metaEvent(byte type, byte *data, uint16 length) {
 	}
 }
 
+bool MidiPlayer::playCachedMusic(const byte *data, uint32 size, bool loop) {
+	SeekableAudioStream *stream;
+	{
+		Common::StackLock lock(_mutex);
+
+		if (!isMusicCacheEnabled() || !_driver || !_device)
+			return false;
+
+		stopRecording(false);
+
+		const Common::String key = makeMusicCacheKey(data, size, getMusicCacheSettings());
+		int volume = 0;
+		stream = openCachedMusic(key, &volume);
+
+		// Synths don't scale their output linearly with the volume, so a
+		// recording only sounds right at the volume it was made at. At any
+		// other volume, synthesise the song again, which replaces it.
+		if (stream && volume > 0 && volume == _masterVolume) {
+			_cachedVolume = volume;
+		} else {
+			delete stream;
+			stream = 0;
+
+			if (_masterVolume > 0) {
+				MusicRecorder *recorder = new MusicRecorder(key, _masterVolume);
+				if (_driver->setRecorder(recorder))
+					_recorder = recorder;
+				else
+					delete recorder;
+			}
+
+			return false;
+		}
+	}
+
+	// The mixer is called without holding _mutex, see onTimer(). The song
+	// only counts as playing once the handle is valid.
+	g_system->getMixer()->playStream(Mixer::kPlainSoundType, &_cacheHandle, makeLoopingAudioStream(stream, loop ? 0 : 1));
+
+	Common::StackLock lock(_mutex);
+	_playingCached = true;
+	_isLooping = loop;
+	_isPlaying = true;
+	return true;
+}
+
+Common::String MidiPlayer::getMusicCacheSettings() const {
+	return Common::String::format("%s %d %d %s %d", MidiDriver::getDeviceString(_device, MidiDriver::kDeviceId).c_str(),
+	                              _nativeMT32, ConfMan.getInt("midi_gain"), ConfMan.get("soundfont").c_str(),
+	                              g_system->getMixer()->getOutputRate());
+}
+
+void MidiPlayer::updateMusicCache() {
+	// Only this thread deletes the recorder, so it can be used without
+	// holding _mutex, which the mixer thread waits for
+	MusicRecorder *recorder;
+	{
+		Common::StackLock lock(_mutex);
+		recorder = _recorder;
+	}
+
+	if (recorder)
+		recorder->flush();
+	MusicRecorder::saveQueued();
+}
+
+void MidiPlayer::stopRecording(bool save) {
+	if (!_recorder)
+		return;
+
+	// Once detached, the driver no longer touches the recorder
+	_driver->setRecorder(0);
+	if (save)
+		_recorder->save();
+	else
+		delete _recorder;
+	_recorder = 0;
+}
+
 void MidiPlayer::endOfTrack() {
+	// The song has played through, so the recording is complete
+	stopRecording(true);
+
 	if (_isLooping) {
 		assert(_parser);
 		_parser->jumpToTick(0);
@@ -148,6 +255,11 @@ void MidiPlayer::timerCallback(void *data) {
 }
 
 void MidiPlayer::onTimer() {
+	// This runs inside the mixer callback for emulated drivers, which holds
+	// the mixer mutex while it waits for _mutex. Everything else must
+	// therefore call the mixer only after releasing _mutex. Querying it
+	// here is fine, as this thread either holds the mixer mutex already or
+	// is a timer thread, which nothing waits on with the mixer mutex held.
 	Common::StackLock lock(_mutex);
 
 	// TODO: Maybe we can replace _isPlaying
@@ -156,40 +268,60 @@ void MidiPlayer::onTimer() {
 	if (_isPlaying && _parser) {
 		_parser->onTimer();
 	}
+
+	if (_playingCached && !g_system->getMixer()->isSoundHandleActive(_cacheHandle)) {
+		_playingCached = false;
+		_isPlaying = false;
+	}
 }
 
 
 void MidiPlayer::stop() {
-	Common::StackLock lock(_mutex);
-
-	_isPlaying = false;
-	if (_parser) {
-		_parser->unloadMusic();
-
-		// FIXME/TODO: The MidiParser destructor calls allNotesOff()
-		// but unloadMusic also does. To suppress double notes-off,
-		// we reset the midi driver of _parser before deleting it.
-		// This smells very fishy, in any case.
-		_parser->setMidiDriver(0);
+	bool playingCached;
+	{
+		Common::StackLock lock(_mutex);
+
+		_isPlaying = false;
+		stopRecording(false);
+		playingCached = _playingCached;
+		_playingCached = false;
+
+		if (_parser) {
+			_parser->unloadMusic();
+
+			// FIXME/TODO: The MidiParser destructor calls allNotesOff()
+			// but unloadMusic also does. To suppress double notes-off,
+			// we reset the midi driver of _parser before deleting it.
+			// This smells very fishy, in any case.
+			_parser->setMidiDriver(0);
+
+			delete _parser;
+			_parser = NULL;
+		}
 
-		delete _parser;
-		_parser = NULL;
+		free(_midiData);
+		_midiData = 0;
 	}
 
-	free(_midiData);
-	_midiData = 0;
+	// The mixer is called without holding _mutex, see onTimer()
+	if (playingCached)
+		g_system->getMixer()->stopHandle(_cacheHandle);
 }
 
 void MidiPlayer::pause() {
 //	debugC(2, kDraciSoundDebugLevel, "Pausing track %d", _track);
 	_isPlaying = false;
 	setVolume(-1);	// FIXME: This should be 0, shouldn't it?
+	if (_playingCached)
+		g_system->getMixer()->pauseHandle(_cacheHandle, true);
 }
 
 void MidiPlayer::resume() {
 //	debugC(2, kDraciSoundDebugLevel, "Resuming track %d", _track);
 	syncVolume();
 	_isPlaying = true;
+	if (_playingCached)
+		g_system->getMixer()->pauseHandle(_cacheHandle, false);
 }
 
 } // End of namespace Audio
@@ -26,11 +26,14 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mididrv.h"
+#include "audio/mixer.h"
 
 class MidiParser;
 
 namespace Audio {
 
+class MusicRecorder;
+
 /**
  * Simple MIDI playback class.
  *
@@ -111,6 +114,14 @@ public:
 	 */
 	void syncVolume();
 
+	/**
+	 * Write the song being recorded to the music cache, and complete the
+	 * recordings of songs that have ended. The save file manager may only
+	 * be used by the engine thread, so the engine has to call this from
+	 * its main loop, e.g. once a frame.
+	 */
+	void updateMusicCache();
+
 	// TODO: Document this
 	bool hasNativeMT32() const { return _nativeMT32; }
 
@@ -141,6 +152,34 @@ protected:
 
 	void createDriver(int flags = MDT_MIDI | MDT_ADLIB | MDT_PREFER_GM);
 
+	/**
+	 * Start playing a song from the music cache, which is enabled with the
+	 * "music_cache" config key. Call this with the song data before loading
+	 * the song into a parser.
+	 *
+	 * If the song was cached at the current volume, it is played from
+	 * there and true is returned. Pausing and stop() apply to it as to a
+	 * synthesised song. Later volume changes only scale the recording,
+	 * which approximates the synth, and can't make it louder than it was
+	 * recorded. Otherwise false is returned and the caller plays the song
+	 * as usual. If the driver is an emulated synth, its output is then
+	 * recorded, and stored in the cache once the song has played to its
+	 * end.
+	 *
+	 * Only works with drivers created by createDriver(). The engine has to
+	 * call updateMusicCache() regularly while the music cache is enabled.
+	 */
+	bool playCachedMusic(const byte *data, uint32 size, bool loop);
+
+	/**
+	 * Return the settings the synth output depends on, for the music cache
+	 * key.
+	 */
+	virtual Common::String getMusicCacheSettings() const;
+
+	/** Detach the music cache recorder and delete or store the recording. */
+	void stopRecording(bool save);
+
 protected:
 	enum {
 		/**
@@ -180,6 +219,21 @@ protected:
 	int _masterVolume;	// FIXME: byte or int ?
 
 	bool _nativeMT32;
+
+	/**
+	 * The device of _driver, if created by createDriver().
+	 */
+	MidiDriver::DeviceHandle _device;
+
+	/**
+	 * Music cache state. Only one of _recorder and _playingCached is set at
+	 * a time: a song is either recorded while it is synthesised, or played
+	 * from the cache through _cacheHandle.
+	 */
+	MusicRecorder *_recorder;
+	bool _playingCached;
+	int _cachedVolume;
+	SoundHandle _cacheHandle;
 };
 
 
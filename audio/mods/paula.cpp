@@ -20,11 +20,16 @@
  *
  */
 
+#include "common/config-manager.h"
+#include "common/math.h"
+
 #include "audio/mods/paula.h"
 #include "audio/null.h"
 
 namespace Audio {
 
+int16 Paula::_blepTable[Paula::kBlepPhases][2 * Paula::kBlepHalfWidth];
+
 Paula::Paula(bool stereo, int rate, uint interruptFreq) :
 		_stereo(stereo), _rate(rate), _periodScale((double)kPalPaulaClock / rate), _intFreq(interruptFreq) {
 
@@ -41,6 +46,9 @@ Paula::Paula(bool stereo, int rate, uint interruptFreq) :
 	_timerBase = 1;
 	_playing = false;
 	_end = true;
+
+	_bandLimited = false;
+	setBandLimited(ConfMan.hasKey("amiga_bandlimited") && ConfMan.getBool("amiga_bandlimited"));
 }
 
 Paula::~Paula() {
@@ -59,6 +67,53 @@ void Paula::clearVoice(byte voice) {
 	_voice[voice].dmaCount = 0;
 }
 
+void Paula::setBandLimited(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	if (enable)
+		initBlepTable();
+
+	_bandLimited = enable;
+	memset(_blepLevel, 0, sizeof(_blepLevel));
+	memset(_blepBuffer, 0, sizeof(_blepBuffer));
+}
+
+void Paula::initBlepTable() {
+	static bool initialized = false;
+	if (initialized)
+		return;
+
+	// Integrate a Blackman windowed sinc, with its cutoff a bit below the
+	// output Nyquist frequency, to get the band-limited step
+	const double cutoff = 0.45;
+	const int substeps = 16;
+	const int points = 2 * kBlepHalfWidth * kBlepPhases;
+	double step[points + 1];
+
+	double sum = 0.0;
+	step[0] = 0.0;
+	for (int i = 0; i < points * substeps; ++i) {
+		const double x = (i + 0.5) / (kBlepPhases * substeps) - kBlepHalfWidth;
+		const double sinc = (x == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+		const double window = 0.42 + 0.5 * cos(M_PI * x / kBlepHalfWidth) + 0.08 * cos(2.0 * M_PI * x / kBlepHalfWidth);
+		sum += sinc * window;
+		if ((i + 1) % substeps == 0)
+			step[(i + 1) / substeps] = sum;
+	}
+
+	// The table holds the difference to a hard step at the output samples
+	// following a step, for each fraction of a sample the step lies back
+	for (int phase = 0; phase < kBlepPhases; ++phase) {
+		for (int i = 0; i < 2 * kBlepHalfWidth; ++i) {
+			const int point = i * kBlepPhases + phase;
+			const double hard = (i >= kBlepHalfWidth) ? 1.0 : 0.0;
+			_blepTable[phase][i] = (int16)floor((step[point] / sum - hard) * 16384.0 + 0.5);
+		}
+	}
+
+	initialized = true;
+}
+
 int Paula::readBuffer(int16 *buffer, const int numSamples) {
 	Common::StackLock lock(_mutex);
 
@@ -73,31 +128,130 @@ int Paula::readBuffer(int16 *buffer, const int numSamples) {
 		return readBufferIntern<false>(buffer, numSamples);
 }
 
+/**
+ * Returns how many samples can be mixed from the current offset before the
+ * end of the buffer is reached, while keeping the position relative to the
+ * offset in 32 bits.
+ */
+inline int samplesToEnd(const Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize) {
+	if (rate <= 0)
+		return neededSamples;
+
+	const uint64 distance = ((uint64)(bufSize - offset.int_off) << FRAC_BITS) - offset.rem_off;
+	return (int)MIN<uint64>(MIN<uint64>(neededSamples, (distance + rate - 1) / rate), 0xFFFF0000U / (uint32)rate);
+}
 
 template<bool stereo>
-inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning) {
-	int samples;
-	for (samples = 0; samples < neededSamples && offset.int_off < bufSize; ++samples) {
-		const int32 tmp = ((int32) data[offset.int_off]) * volume;
+inline int mixBuffer(int32 *&mix, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning) {
+	const int32 volumeLeft = volume * (255 - panning);
+	const int32 volumeRight = volume * panning;
+
+	int samples = 0;
+	while (samples < neededSamples && offset.int_off < bufSize) {
+		const int count = samplesToEnd(offset, rate, neededSamples - samples, bufSize);
+		const int8 *src = data + offset.int_off;
+		uint32 pos = offset.rem_off;
+
 		if (stereo) {
-			*buf++ += (tmp * (255 - panning)) >> 7;
-			*buf++ += (tmp * (panning)) >> 7;
-		} else
-			*buf++ += tmp;
-
-		// Step to next source sample
-		offset.rem_off += rate;
-		if (offset.rem_off >= (frac_t)FRAC_ONE) {
-			offset.int_off += fracToInt(offset.rem_off);
-			offset.rem_off &= FRAC_LO_MASK;
+			for (int i = 0; i < count; ++i, mix += 2) {
+				const int32 sample = src[pos >> FRAC_BITS];
+				mix[0] += (sample * volumeLeft) >> 7;
+				mix[1] += (sample * volumeRight) >> 7;
+				pos += rate;
+			}
+		} else {
+			for (int i = 0; i < count; ++i) {
+				*mix++ += src[pos >> FRAC_BITS] * volume;
+				pos += rate;
+			}
 		}
+
+		offset.int_off += pos >> FRAC_BITS;
+		offset.rem_off = pos & FRAC_LO_MASK;
+		samples += count;
 	}
 
 	return samples;
 }
 
+template<bool stereo>
+inline void addStep(int32 *mix, int32 delta, const int16 *step) {
+	for (int i = 0; i < 2 * Paula::kBlepHalfWidth; ++i)
+		mix[stereo ? 2 * i : i] += (delta * step[i]) >> 14;
+}
+
+/**
+ * Changes the level of a voice for band-limited mixing. The step lies the
+ * given fraction of a sample, in units of 1/kBlepPhases, before the output
+ * sample mix points to.
+ */
+template<bool stereo>
+inline void setLevel(int32 *mix, int32 *level, const int32 *volume, int32 sample, uint phase, const int16 *table) {
+	for (int channel = 0; channel < (stereo ? 2 : 1); ++channel) {
+		const int32 newLevel = sample * volume[channel];
+		if (newLevel != level[channel]) {
+			addStep<stereo>(mix + channel, newLevel - level[channel], table + phase * 2 * Paula::kBlepHalfWidth);
+			level[channel] = newLevel;
+		}
+	}
+}
+
+template<bool stereo>
+inline int mixBufferBandLimited(int32 *&mix, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, const int32 *volume, int32 *level, const int16 *table) {
+	const int channels = stereo ? 2 : 1;
+
+	int samples = 0;
+	while (samples < neededSamples && offset.int_off < bufSize) {
+		const int count = samplesToEnd(offset, rate, neededSamples - samples, bufSize);
+		const int8 *src = data + offset.int_off;
+		uint32 pos = offset.rem_off;
+		uint32 index = 0;
+
+		setLevel<stereo>(mix, level, volume, src[0], 0, table);
+		for (int i = 0; i < count; ++i, mix += channels) {
+			// Add a step for every sample passed since the last output sample
+			while (index < (pos >> FRAC_BITS)) {
+				++index;
+				const uint phase = (uint)(((uint64)(pos - (index << FRAC_BITS)) * Paula::kBlepPhases) / (uint32)rate);
+				setLevel<stereo>(mix, level, volume, src[index], phase, table);
+			}
+
+			mix[Paula::kBlepHalfWidth * channels] += level[0];
+			if (stereo)
+				mix[Paula::kBlepHalfWidth * channels + 1] += level[1];
+			pos += rate;
+		}
+
+		offset.int_off += pos >> FRAC_BITS;
+		offset.rem_off = pos & FRAC_LO_MASK;
+		samples += count;
+	}
+
+	return samples;
+}
+
+template<bool stereo>
+int Paula::mixChannel(int32 *&mix, Channel &ch, byte voice, frac_t rate, int neededSamples) {
+	if (!_bandLimited)
+		return mixBuffer<stereo>(mix, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
+
+	// Scale the volume before the steps, to keep them in 32 bits
+	int32 volume[2];
+	if (stereo) {
+		volume[0] = (ch.volume * (255 - ch.panning)) >> 7;
+		volume[1] = (ch.volume * ch.panning) >> 7;
+	} else {
+		volume[0] = ch.volume;
+	}
+
+	return mixBufferBandLimited<stereo>(mix, ch.data, ch.offset, rate, neededSamples, ch.length, volume, _blepLevel[voice], _blepTable[0]);
+}
+
 template<bool stereo>
 int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
+	const int channels = stereo ? 2 : 1;
+	int32 mixBuffer[kMixChunk * 2];
+
 	int samples = _stereo ? numSamples / 2 : numSamples;
 	while (samples > 0) {
 
@@ -109,14 +263,24 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 		}
 
 		// Compute how many samples to generate: at most the requested number of samples,
-		// of course, but we may stop earlier when an 'interrupt' is expected.
-		const uint nSamples = MIN((uint)samples, _curInt);
+		// of course, but we may stop earlier when an 'interrupt' is expected. The voices
+		// are mixed into a 32 bit buffer one after another, a chunk at a time.
+		const uint nSamples = MIN(MIN((uint)samples, _curInt), (uint)kMixChunk);
+		int32 *mix = _bandLimited ? _blepBuffer : mixBuffer;
+		if (!_bandLimited)
+			memset(mixBuffer, 0, nSamples * channels * sizeof(int32));
 
 		// Loop over the four channels of the emulated Paula chip
 		for (int voice = 0; voice < NUM_VOICES; voice++) {
 			// No data, or paused -> skip channel
-			if (!_voice[voice].data || (_voice[voice].period <= 0))
+			if (!_voice[voice].data || (_voice[voice].period <= 0)) {
+				// Let a band-limited voice fall silent at the start of the chunk
+				if (_bandLimited) {
+					static const int32 silence[2] = { 0, 0 };
+					setLevel<stereo>(mix, _blepLevel[voice], silence, 0, 0, _blepTable[0]);
+				}
 				continue;
+			}
 
 			// The Paula chip apparently run at 7.0937892 MHz in the PAL
 			// version and at 7.1590905 MHz in the NTSC version. We divide this
@@ -130,7 +294,7 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 
 
 			Channel &ch = _voice[voice];
-			int16 *p = buffer;
+			int32 *p = mix;
 			int neededSamples = nSamples;
 
 			// NOTE: A Protracker (or other module format) player might actually
@@ -142,7 +306,7 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 			// by the OS/2 version of Hopkins FBI.
 
 			// Mix the generated samples into the output buffer
-			neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
+			neededSamples -= mixChannel<stereo>(p, ch, voice, rate, neededSamples);
 
 			// Wrap around if necessary
 			if (ch.offset.int_off >= ch.length) {
@@ -164,7 +328,7 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 				// Repeat as long as necessary.
 				while (neededSamples > 0) {
 					// Mix the generated samples into the output buffer
-					neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
+					neededSamples -= mixChannel<stereo>(p, ch, voice, rate, neededSamples);
 
 					if (ch.offset.int_off >= ch.length) {
 						// Wrap around. See also the note above.
@@ -175,7 +339,25 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 			}
 
 		}
-		buffer += _stereo ? nSamples * 2 : nSamples;
+
+		const uint mixed = nSamples * channels;
+		if (_bandLimited) {
+			// The steps overshoot, so clip the output. Then keep the
+			// tails of the steps reaching into the next chunk.
+			for (uint i = 0; i < mixed; ++i)
+				buffer[i] = CLIP<int32>(_blepBuffer[i], -32768, 32767);
+
+			const uint tail = 2 * kBlepHalfWidth * channels;
+			memmove(_blepBuffer, _blepBuffer + mixed, tail * sizeof(int32));
+			memset(_blepBuffer + tail, 0, mixed * sizeof(int32));
+		} else {
+			// Like adding to the 16 bit output for each voice, the sum
+			// wraps around
+			for (uint i = 0; i < mixed; ++i)
+				buffer[i] = (int16)mixBuffer[i];
+		}
+
+		buffer += mixed;
 		_curInt -= nSamples;
 		samples -= nSamples;
 	}
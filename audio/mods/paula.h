@@ -46,6 +46,15 @@ public:
 		kNtscPauleClock  = kNtscSystemClock / 2
 	};
 
+	enum {
+		/** Number of samples mixed at once */
+		kMixChunk = 256,
+		/** Half the length of a band-limited step, in output samples */
+		kBlepHalfWidth = 8,
+		/** Number of phases a band-limited step is tabulated for */
+		kBlepPhases = 64
+	};
+
 	/* TODO: Document this */
 	struct Offset {
 		uint	int_off;	// integral part of the offset
@@ -74,6 +83,16 @@ public:
 	void stopPlay() { _playing = false; }
 	void pausePlay(bool pause) { _playing = !pause; }
 
+	/**
+	 * Select band-limited mixing. Instead of holding each sample until the
+	 * next one, like the real chip, the steps between samples are filtered
+	 * to the output bandwidth. This removes the aliasing of high pitched
+	 * voices, at the cost of a few samples of delay. It is enabled by
+	 * default when the "amiga_bandlimited" config key is set.
+	 */
+	void setBandLimited(bool enable);
+	bool isBandLimited() const { return _bandLimited; }
+
 // AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
 	bool isStereo() const { return _stereo; }
@@ -198,8 +217,20 @@ private:
 	uint32 _timerBase;
 	bool _playing;
 
+	bool _bandLimited;
+	/** Output level of each voice and output channel for band-limited mixing */
+	int32 _blepLevel[NUM_VOICES][2];
+	/** Mixed samples including the tails of the steps that reach into the next chunk */
+	int32 _blepBuffer[(kMixChunk + 2 * kBlepHalfWidth) * 2];
+
+	/** Difference between a band-limited and a hard step, for each phase of the step */
+	static int16 _blepTable[kBlepPhases][2 * kBlepHalfWidth];
+	static void initBlepTable();
+
 	template<bool stereo>
 	int readBufferIntern(int16 *buffer, const int numSamples);
+	template<bool stereo>
+	int mixChannel(int32 *&mix, Channel &ch, byte voice, frac_t rate, int neededSamples);
 };
 
 } // End of namespace Audio
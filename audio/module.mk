@@ -14,6 +14,7 @@ MODULE_OBJS := \
 	miles_mt32.o \
 	mixer.o \
 	mpu401.o \
+	musiccache.o \
 	musicplugin.o \
 	null.o \
 	timestamp.o \
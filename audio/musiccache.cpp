@@ -0,0 +1,304 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "audio/musiccache.h"
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/hash-str.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Audio {
+
+enum {
+	kCacheVersion = 2
+};
+
+// A song is cached in two files. The data file holds the samples, and is
+// written while the song plays. The index file holds their format, and is
+// only written once the data file is complete.
+static Common::String indexFileName(const Common::String &key) {
+	return key + ".pcm";
+}
+
+static Common::String dataFileName(const Common::String &key) {
+	return key + ".dat";
+}
+
+Common::Mutex *MusicRecorder::_saveMutex = 0;
+Common::Array<MusicRecorder *> *MusicRecorder::_saveQueue = 0;
+
+MusicRecorder::MusicRecorder(const Common::String &key, int volume)
+    : _key(key), _volume(volume), _rate(0), _stereo(false), _numSamples(0), _dropped(false),
+      _file(0), _writtenSamples(0) {
+	if (!_saveMutex) {
+		_saveMutex = new Common::Mutex();
+		_saveQueue = new Common::Array<MusicRecorder *>();
+	}
+}
+
+MusicRecorder::~MusicRecorder() {
+	if (_file) {
+		// The song did not play to its end
+		delete _file;
+		g_system->getSavefileManager()->removeSavefile(dataFileName(_key));
+	}
+
+	for (uint i = 0; i < _chunks.size(); ++i)
+		delete[] _chunks[i];
+}
+
+void MusicRecorder::setFormat(int rate, bool stereo) {
+	_rate = rate;
+	_stereo = stereo;
+}
+
+void MusicRecorder::write(const int16 *data, int numSamples) {
+	Common::StackLock lock(_mutex);
+	if (_dropped)
+		return;
+
+	if (_numSamples + numSamples > (uint32)kMaxSeconds * _rate * (_stereo ? 2 : 1)) {
+		// Too long for the cache, most likely a song that never ends
+		_dropped = true;
+		return;
+	}
+
+	while (numSamples > 0) {
+		const uint32 offset = _numSamples % kChunkSamples;
+		if (!offset) {
+			if (_chunks.size() >= kMaxPendingChunks) {
+				warning("MusicRecorder: Recording of '%s' is not flushed, dropping it", _key.c_str());
+				_dropped = true;
+				return;
+			}
+			_chunks.push_back(new int16[kChunkSamples]);
+		}
+
+		const int step = MIN<int>(numSamples, kChunkSamples - offset);
+		memcpy(_chunks.back() + offset, data, step * sizeof(int16));
+		_numSamples += step;
+		data += step;
+		numSamples -= step;
+	}
+}
+
+void MusicRecorder::flush() {
+	writePending(false);
+}
+
+void MusicRecorder::writePending(bool all) {
+	Common::Array<int16 *> chunks;
+	uint32 samples;
+	{
+		Common::StackLock lock(_mutex);
+		if (_dropped)
+			return;
+
+		// Unless the recording is complete, the last chunk is still
+		// being filled
+		samples = _numSamples - _writtenSamples;
+		if (!all)
+			samples -= samples % kChunkSamples;
+
+		const uint count = (samples + kChunkSamples - 1) / kChunkSamples;
+		for (uint i = 0; i < count; ++i)
+			chunks.push_back(_chunks.remove_at(0));
+	}
+
+	if (chunks.empty())
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!_file && !_writtenSamples) {
+		// The index of an older recording of the song would not match
+		saveFileMan->removeSavefile(indexFileName(_key));
+		_file = saveFileMan->openForSaving(dataFileName(_key));
+		if (!_file)
+			warning("MusicRecorder: Could not create cache file '%s'", dataFileName(_key).c_str());
+	}
+
+	for (uint i = 0; i < chunks.size(); ++i) {
+		const uint32 step = MIN<uint32>(samples, kChunkSamples);
+		if (_file) {
+			for (uint32 j = 0; j < step; ++j)
+				WRITE_LE_UINT16(chunks[i] + j, chunks[i][j]);
+			_file->write(chunks[i], step * sizeof(int16));
+		}
+		_writtenSamples += step;
+		samples -= step;
+		delete[] chunks[i];
+	}
+
+	if (!_file || _file->err()) {
+		Common::StackLock lock(_mutex);
+		_dropped = true;
+	}
+}
+
+void MusicRecorder::save() {
+	Common::StackLock lock(*_saveMutex);
+	_saveQueue->push_back(this);
+}
+
+void MusicRecorder::saveQueued() {
+	if (!_saveMutex)
+		return;
+
+	for (;;) {
+		MusicRecorder *recorder;
+		{
+			Common::StackLock lock(*_saveMutex);
+			if (_saveQueue->empty())
+				return;
+			recorder = _saveQueue->remove_at(0);
+		}
+
+		recorder->finish();
+		delete recorder;
+	}
+}
+
+void MusicRecorder::finish() {
+	writePending(true);
+
+	// The recorder has been detached, so nothing writes to it any more
+	if (_dropped || !_file || !_rate)
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+
+	_file->finalize();
+	const bool failed = _file->err();
+	delete _file;
+	_file = 0;
+
+	if (!failed) {
+		Common::OutSaveFile *index = saveFileMan->openForSaving(indexFileName(_key));
+		if (index) {
+			index->writeUint32BE(MKTAG('M', 'C', 'A', 'C'));
+			index->writeUint32BE(kCacheVersion);
+			index->writeUint32BE(_rate);
+			index->writeByte(_stereo);
+			index->writeByte(_volume);
+			index->writeUint32BE(_numSamples);
+			index->finalize();
+
+			if (!index->err()) {
+				delete index;
+				debug(1, "MusicRecorder: Cached %u samples as '%s'", _numSamples, _key.c_str());
+				trimCache();
+				return;
+			}
+			delete index;
+		}
+	}
+
+	warning("MusicRecorder: Could not write cache file '%s'", _key.c_str());
+	saveFileMan->removeSavefile(indexFileName(_key));
+	saveFileMan->removeSavefile(dataFileName(_key));
+}
+
+void MusicRecorder::trimCache() {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::StringArray files = saveFileMan->listSavefiles("music-*.dat");
+
+	// The size on disk, which is compressed if the backend compresses
+	// save files. The index files are too small to matter.
+	Common::Array<uint32> sizes;
+	uint32 total = 0;
+	for (uint i = 0; i < files.size(); ++i) {
+		uint32 size = 0;
+		Common::InSaveFile *file = saveFileMan->openRawFile(files[i]);
+		if (file)
+			size = file->size();
+		delete file;
+		sizes.push_back(size);
+		total += size;
+	}
+
+	// Save files have no timestamps, so there is no telling which songs
+	// were used last. Remove them in the order they are listed.
+	for (uint i = 0; i < files.size() && total > kMaxCacheSize; ++i) {
+		if (files[i] == dataFileName(_key))
+			continue;
+
+		const Common::String key(files[i].c_str(), files[i].size() - 4);
+		debug(1, "MusicRecorder: Removing '%s' to stay below the cache size", key.c_str());
+		saveFileMan->removeSavefile(indexFileName(key));
+		if (saveFileMan->removeSavefile(files[i]))
+			total -= sizes[i];
+	}
+}
+
+bool isMusicCacheEnabled() {
+	return ConfMan.hasKey("music_cache") && ConfMan.getBool("music_cache");
+}
+
+Common::String makeMusicCacheKey(const byte *data, uint32 size, const Common::String &settings) {
+	Common::MemoryReadStream stream(data, size);
+	const Common::String md5 = Common::computeStreamMD5AsString(stream);
+	return Common::String::format("music-%s-%08x", md5.c_str(), Common::hashit(settings));
+}
+
+SeekableAudioStream *openCachedMusic(const Common::String &key, int *volume) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::InSaveFile *index = saveFileMan->openForLoading(indexFileName(key));
+	if (!index)
+		return 0;
+
+	if (index->readUint32BE() != MKTAG('M', 'C', 'A', 'C') || index->readUint32BE() != kCacheVersion) {
+		warning("openCachedMusic: '%s' is not a music cache file", indexFileName(key).c_str());
+		delete index;
+		return 0;
+	}
+
+	const int rate = index->readUint32BE();
+	const bool stereo = index->readByte() != 0;
+	*volume = index->readByte();
+	const uint32 numSamples = index->readUint32BE();
+	const bool err = index->err();
+	delete index;
+
+	Common::SeekableReadStream *samples = err ? 0 : saveFileMan->openForLoading(dataFileName(key));
+	if (!samples || !numSamples || samples->size() != (int32)(numSamples * sizeof(int16)) || numSamples % (stereo ? 2 : 1)) {
+		warning("openCachedMusic: '%s' is damaged", key.c_str());
+		delete samples;
+		return 0;
+	}
+
+	byte flags = FLAG_16BITS | FLAG_LITTLE_ENDIAN;
+	if (stereo)
+		flags |= FLAG_STEREO;
+
+	return makeRawStream(samples, rate, flags);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,152 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef AUDIO_MUSICCACHE_H
+#define AUDIO_MUSICCACHE_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+namespace Common {
+class OutSaveFile;
+}
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * Records what a synth outputs while it plays a song, so the song can be
+ * played from the music cache the next time instead of being synthesised
+ * again.
+ *
+ * The recorder is attached to a driver with MidiDriver::setRecorder(),
+ * which passes it the output format and every sample it renders from then
+ * on. The save file manager may only be used from the engine thread, so
+ * the samples are only buffered by write(). flush() writes them to the
+ * save directory, and has to be called regularly from the engine thread.
+ * Once the song has played to its end, save() queues the recording, and
+ * saveQueued() completes it on the engine thread.
+ */
+class MusicRecorder {
+public:
+	/**
+	 * @param key		cache key of the song, see makeMusicCacheKey()
+	 * @param volume	master volume the song is played at, in the range 0-255
+	 */
+	MusicRecorder(const Common::String &key, int volume);
+
+	/** Delete an incomplete recording. Only call from the engine thread. */
+	~MusicRecorder();
+
+	/** Called by the driver when the recorder is attached. */
+	void setFormat(int rate, bool stereo);
+
+	/** Append numSamples samples of synth output to the recording. */
+	void write(const int16 *data, int numSamples);
+
+	/** Write the samples recorded so far. Only call from the engine thread. */
+	void flush();
+
+	/**
+	 * Queue the recording to be stored in the cache by saveQueued(). The
+	 * recorder must have been detached from the driver first, and is
+	 * deleted once stored.
+	 */
+	void save();
+
+	/**
+	 * Store the recordings queued by save() in the cache. Only call from
+	 * the engine thread.
+	 */
+	static void saveQueued();
+
+private:
+	enum {
+		kChunkSamples = 8192,
+		/**
+		 * Maximal number of chunks waiting for flush(). If the engine
+		 * does not flush in time, the recording is dropped.
+		 */
+		kMaxPendingChunks = 128,
+		kMaxSeconds = 300,
+		kMaxCacheSize = 256 * 1024 * 1024
+	};
+
+	/**
+	 * Write the recorded samples. Unless all is set, the last chunk is
+	 * kept, as it is still being filled.
+	 */
+	void writePending(bool all);
+
+	/** Complete the cache files, after the song has ended. */
+	void finish();
+
+	/** Remove other cache files until the cache fits in kMaxCacheSize bytes. */
+	void trimCache();
+
+	const Common::String _key;
+	const int _volume;
+	int _rate;
+	bool _stereo;
+
+	/** Guards the recorded samples, which are shared with the mixer thread. */
+	Common::Mutex _mutex;
+	Common::Array<int16 *> _chunks;
+	uint32 _numSamples;
+	bool _dropped;
+
+	/** Only used on the engine thread */
+	Common::OutSaveFile *_file;
+	uint32 _writtenSamples;
+
+	static Common::Mutex *_saveMutex;
+	static Common::Array<MusicRecorder *> *_saveQueue;
+};
+
+/**
+ * Return whether the music cache is enabled with the "music_cache"
+ * config key.
+ */
+bool isMusicCacheEnabled();
+
+/**
+ * Build the cache key for a song. Besides the song data, the key has to
+ * include every setting the synth output depends on, like the device and
+ * the output rate. The cache files of the song are named after the key.
+ */
+Common::String makeMusicCacheKey(const byte *data, uint32 size, const Common::String &settings);
+
+/**
+ * Open a song from the music cache.
+ *
+ * @param key		cache key of the song
+ * @param volume	set to the master volume the song was recorded at
+ * @return the recorded song, or 0 if it is not in the cache
+ */
+SeekableAudioStream *openCachedMusic(const Common::String &key, int *volume);
+
+} // End of namespace Audio
+
+#endif
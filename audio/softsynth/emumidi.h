@@ -26,6 +26,9 @@
 #include "audio/audiostream.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
+#include "audio/musiccache.h"
+
+#include "common/mutex.h"
 
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
@@ -44,12 +47,26 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	Common::Mutex _recorderMutex;
+	Audio::MusicRecorder *_recorder;
+
 protected:
 	int _baseFreq;
 
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Pass generated samples to the recorder, if one is attached. Drivers
+	 * which override readBuffer() call this before running the timer
+	 * callback, like readBuffer() does.
+	 */
+	void recordSamples(const int16 *data, int numSamples) {
+		Common::StackLock lock(_recorderMutex);
+		if (_recorder)
+			_recorder->write(data, numSamples);
+	}
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -58,6 +75,7 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_recorder(0),
 		_baseFreq(250) {
 	}
 
@@ -87,6 +105,14 @@ public:
 		return 1000000 / _baseFreq;
 	}
 
+	virtual bool setRecorder(Audio::MusicRecorder *recorder) {
+		Common::StackLock lock(_recorderMutex);
+		_recorder = recorder;
+		if (_recorder)
+			_recorder->setFormat(getRate(), isStereo());
+		return true;
+	}
+
 	// AudioStream API
 	virtual int readBuffer(int16 *data, const int numSamples) {
 		const int stereoFactor = isStereo() ? 2 : 1;
@@ -99,6 +125,7 @@ public:
 				step = (_nextTick >> FIXP_SHIFT);
 
 			generateSamples(data, step);
+			recordSamples(data, step * stereoFactor);
 
 			_nextTick -= step << FIXP_SHIFT;
 			if (!(_nextTick >> FIXP_SHIFT)) {
@@ -37,7 +37,11 @@ public:
 	void frequency(int freq);
 	void updatePhaseIncrement();
 	void recalculateRates();
-	void generateOutput(int32 phasebuf, int32 *feedbuf, int32 &out);
+	inline void generateOutput(int32 phasebuf, int32 *feedbuf, int32 &out);
+
+	bool isActive() const {
+		return _state != kEnvReady;
+	}
 
 	void feedbackLevel(int32 level);
 	void detune(int value);
@@ -53,6 +57,8 @@ public:
 	void reset();
 
 protected:
+	bool updateEnvelope();
+
 	EnvelopeState _state;
 	bool _holdKey;
 	uint32 _feedbackLevel;
@@ -162,66 +168,15 @@ void TownsPC98_FmSynthOperator::recalculateRates() {
 	fs_r.shift = _rshiftTbl[r + k];
 }
 
-void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int32 &out) {
+inline void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int32 &out) {
 	if (_state == kEnvReady)
 		return;
 
 	_timer += _tickLength;
 	while (_timer > _rtt) {
 		_timer -= _rtt;
-		++_tickCount;
-
-		int32 levelIncrement = 0;
-		uint32 targetTime = 0;
-		int32 targetLevel = 0;
-		EnvelopeState nextState = kEnvReady;
-
-		for (bool loop = true; loop;) {
-			switch (_state) {
-			case kEnvReady:
-				return;
-			case kEnvAttacking:
-				targetLevel = 0;
-				nextState = _sustainLevel ? kEnvDecaying : kEnvSustaining;
-				if ((_specifiedAttackRate << 1) + _keyScale2 < 62) {
-					targetTime = (1 << fs_a.shift) - 1;
-					levelIncrement = (~_currentLevel * _adTbl[fs_a.rate + ((_tickCount >> fs_a.shift) & 7)]) >> 4;
-				} else {
-					_currentLevel = targetLevel;
-					_state = nextState;
-					continue;
-				}
-				break;
-			case kEnvDecaying:
-				targetTime = (1 << fs_d.shift) - 1;
-				nextState = kEnvSustaining;
-				targetLevel = _sustainLevel;
-				levelIncrement = _adTbl[fs_d.rate + ((_tickCount >> fs_d.shift) & 7)];
-				break;
-			case kEnvSustaining:
-				targetTime = (1 << fs_s.shift) - 1;
-				nextState = kEnvSustaining;
-				targetLevel = 1023;
-				levelIncrement = _adTbl[fs_s.rate + ((_tickCount >> fs_s.shift) & 7)];
-				break;
-			case kEnvReleasing:
-				targetTime = (1 << fs_r.shift) - 1;
-				nextState = kEnvReady;
-				targetLevel = 1023;
-				levelIncrement = _adTbl[fs_r.rate + ((_tickCount >> fs_r.shift) & 7)];
-				break;
-			}
-			loop = false;
-		}
-
-		if (!(_tickCount & targetTime)) {
-			_currentLevel += levelIncrement;
-			if ((_state == kEnvAttacking && _currentLevel <= targetLevel) || (_state != kEnvAttacking && _currentLevel >= targetLevel)) {
-				if (_state != kEnvDecaying)
-					_currentLevel = targetLevel;
-				_state = nextState;
-			}
-		}
+		if (!updateEnvelope())
+			return;
 	}
 
 	uint32 lvlout = _totalLevel + (uint32) _currentLevel;
@@ -252,6 +207,64 @@ void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int3
 	out += *o;
 }
 
+bool TownsPC98_FmSynthOperator::updateEnvelope() {
+	++_tickCount;
+
+	int32 levelIncrement = 0;
+	uint32 targetTime = 0;
+	int32 targetLevel = 0;
+	EnvelopeState nextState = kEnvReady;
+
+	for (bool loop = true; loop;) {
+		switch (_state) {
+		case kEnvReady:
+			return false;
+		case kEnvAttacking:
+			targetLevel = 0;
+			nextState = _sustainLevel ? kEnvDecaying : kEnvSustaining;
+			if ((_specifiedAttackRate << 1) + _keyScale2 < 62) {
+				targetTime = (1 << fs_a.shift) - 1;
+				levelIncrement = (~_currentLevel * _adTbl[fs_a.rate + ((_tickCount >> fs_a.shift) & 7)]) >> 4;
+			} else {
+				_currentLevel = targetLevel;
+				_state = nextState;
+				continue;
+			}
+			break;
+		case kEnvDecaying:
+			targetTime = (1 << fs_d.shift) - 1;
+			nextState = kEnvSustaining;
+			targetLevel = _sustainLevel;
+			levelIncrement = _adTbl[fs_d.rate + ((_tickCount >> fs_d.shift) & 7)];
+			break;
+		case kEnvSustaining:
+			targetTime = (1 << fs_s.shift) - 1;
+			nextState = kEnvSustaining;
+			targetLevel = 1023;
+			levelIncrement = _adTbl[fs_s.rate + ((_tickCount >> fs_s.shift) & 7)];
+			break;
+		case kEnvReleasing:
+			targetTime = (1 << fs_r.shift) - 1;
+			nextState = kEnvReady;
+			targetLevel = 1023;
+			levelIncrement = _adTbl[fs_r.rate + ((_tickCount >> fs_r.shift) & 7)];
+			break;
+		}
+		loop = false;
+	}
+
+	if (!(_tickCount & targetTime)) {
+		_currentLevel += levelIncrement;
+		if ((_state == kEnvAttacking && _currentLevel <= targetLevel) || (_state != kEnvAttacking && _currentLevel >= targetLevel)) {
+			if (_state != kEnvDecaying)
+				_currentLevel = targetLevel;
+			_state = nextState;
+		}
+	}
+
+	return true;
+}
+
 void TownsPC98_FmSynthOperator::feedbackLevel(int32 level) {
 	_feedbackLevel = level ? level + 6 : 0;
 }
@@ -862,6 +875,7 @@ TownsPC98_FmSynth::TownsPC98_FmSynth(Audio::Mixer *mixer, EmuType type, bool ext
 	_oprRates(0), _oprRateshift(0), _oprAttackDecay(0), _oprFrq(0), _oprSinTbl(0), _oprLevelOut(0), _oprDetune(0),
 	 _rtt(type == kTypeTowns ? 0x514767 : 0x5B8D80), _baserate(55125.0f / (float)mixer->getOutputRate()),
 	_volMaskA(0), _volMaskB(0), _volumeA(255), _volumeB(255),
+	_renderBuffer(0), _chanBuffer(0), _renderBufferSize(0),
 	_regProtectionFlag(false), _externalMutex(externalMutexHandling), _ready(false) {
 
 	memset(&_timers[0], 0, sizeof(ChipTimer));
@@ -890,6 +904,9 @@ TownsPC98_FmSynth::~TownsPC98_FmSynth() {
 	delete[] _oprSinTbl;
 	delete[] _oprLevelOut;
 	delete[] _oprDetune;
+
+	delete[] _renderBuffer;
+	delete[] _chanBuffer;
 }
 
 bool TownsPC98_FmSynth::init() {
@@ -1143,8 +1160,16 @@ void TownsPC98_FmSynth::writeReg(uint8 part, uint8 regAddress, uint8 value) {
 
 int TownsPC98_FmSynth::readBuffer(int16 *buffer, const int numSamples) {
 	memset(buffer, 0, sizeof(int16) * numSamples);
-	int32 *tmp = new int32[numSamples];
-	int32 *tmpStart = tmp;
+
+	if (_renderBufferSize < numSamples) {
+		delete[] _renderBuffer;
+		delete[] _chanBuffer;
+		_renderBuffer = new int32[numSamples];
+		_chanBuffer = new int32[(numSamples >> 1) + 1];
+		_renderBufferSize = numSamples;
+	}
+
+	int32 *tmp = _renderBuffer;
 	memset(tmp, 0, sizeof(int32) * numSamples);
 	int32 samplesLeft = numSamples >> 1;
 
@@ -1218,8 +1243,6 @@ int TownsPC98_FmSynth::readBuffer(int16 *buffer, const int numSamples) {
 	if (locked)
 		_mutex.unlock();
 
-	delete[] tmpStart;
-
 	return numSamples;
 }
 
@@ -1351,100 +1374,154 @@ void TownsPC98_FmSynth::generateTables() {
 	delete[] dtt;
 }
 
+/**
+ * Generates the unscaled output of one fm channel. The algorithm is a
+ * template parameter so that the operator routing is resolved once per
+ * block instead of once per sample.
+ */
+template<int algorithm>
+static void generateChannelOutput(TownsPC98_FmSynthOperator **o, int32 *feed, int32 *output, uint32 numSamples) {
+	int32 *del = &feed[2];
+
+	for (uint32 i = 0; i < numSamples; i++) {
+		int32 phbuf1, phbuf2, out;
+		phbuf1 = phbuf2 = out = 0;
+
+		switch (algorithm) {
+		case 0:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			*del = 0;
+			o[1]->generateOutput(phbuf1, 0, *del);
+			o[3]->generateOutput(phbuf2, 0, out);
+			break;
+		case 1:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			o[1]->generateOutput(0, 0, phbuf1);
+			o[3]->generateOutput(phbuf2, 0, out);
+			*del = phbuf1;
+			break;
+		case 2:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			o[1]->generateOutput(0, 0, phbuf1);
+			o[3]->generateOutput(phbuf2, 0, out);
+			*del = phbuf1;
+			break;
+		case 3:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(0, 0, *del);
+			o[1]->generateOutput(phbuf2, 0, phbuf1);
+			o[3]->generateOutput(*del, 0, out);
+			*del = phbuf1;
+			break;
+		case 4:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, 0, phbuf2);
+			o[1]->generateOutput(phbuf1, 0, out);
+			o[3]->generateOutput(phbuf2, 0, out);
+			*del = 0;
+			break;
+		case 5:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, out);
+			o[1]->generateOutput(phbuf1, 0, out);
+			o[3]->generateOutput(phbuf1, 0, out);
+			*del = phbuf1;
+			break;
+		case 6:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, 0, out);
+			o[1]->generateOutput(phbuf1, 0, out);
+			o[3]->generateOutput(0, 0, out);
+			*del = 0;
+			break;
+		case 7:
+			o[0]->generateOutput(0, feed, out);
+			o[2]->generateOutput(0, 0, out);
+			o[1]->generateOutput(0, 0, out);
+			o[3]->generateOutput(0, 0, out);
+			*del = 0;
+			break;
+		};
+
+		output[i] = out;
+	}
+}
+
 void TownsPC98_FmSynth::nextTick(int32 *buffer, uint32 bufferSize) {
 	if (!_ready)
 		return;
 
+	const int32 divisor = (_numChan + _numSSG - 3) / 3;
+
 	for (int i = 0; i < _numChan; i++) {
-		TownsPC98_FmSynthOperator **o = _chanInternal[i].opr;
+		ChanInternal &chan = _chanInternal[i];
+		TownsPC98_FmSynthOperator **o = chan.opr;
 
-		if (_chanInternal[i].updateEnvelopeParameters) {
-			_chanInternal[i].updateEnvelopeParameters = false;
+		if (chan.updateEnvelopeParameters) {
+			chan.updateEnvelopeParameters = false;
 			for (int ii = 0; ii < 4 ; ii++)
 				o[ii]->updatePhaseIncrement();
 		}
 
-		for (uint32 ii = 0; ii < bufferSize ; ii++) {
-			int32 phbuf1, phbuf2, output;
-			phbuf1 = phbuf2 = output = 0;
-
-			int32 *leftSample = &buffer[ii * 2];
-			int32 *rightSample = &buffer[ii * 2 + 1];
-			int32 *del = &_chanInternal[i].feedbuf[2];
-			int32 *feed = _chanInternal[i].feedbuf;
-
-			switch (_chanInternal[i].algorithm) {
-			case 0:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				*del = 0;
-				o[1]->generateOutput(phbuf1, 0, *del);
-				o[3]->generateOutput(phbuf2, 0, output);
-				break;
-			case 1:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				o[1]->generateOutput(0, 0, phbuf1);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = phbuf1;
-				break;
-			case 2:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				o[1]->generateOutput(0, 0, phbuf1);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = phbuf1;
-				break;
-			case 3:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(0, 0, *del);
-				o[1]->generateOutput(phbuf2, 0, phbuf1);
-				o[3]->generateOutput(*del, 0, output);
-				*del = phbuf1;
-				break;
-			case 4:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, 0, phbuf2);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = 0;
-				break;
-			case 5:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, output);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(phbuf1, 0, output);
-				*del = phbuf1;
-				break;
-			case 6:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, 0, output);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(0, 0, output);
-				*del = 0;
-				break;
-			case 7:
-				o[0]->generateOutput(0, feed, output);
-				o[2]->generateOutput(0, 0, output);
-				o[1]->generateOutput(0, 0, output);
-				o[3]->generateOutput(0, 0, output);
-				*del = 0;
-				break;
-			};
-
-			int32 finOut = (output << 2) / ((_numChan + _numSSG - 3) / 3);
-
-			if ((1 << i) & _volMaskA)
+		// Operators which have finished their release phase don't advance
+		// and don't produce any output. When all four of them are idle
+		// every algorithm just leaves the delay buffer cleared behind.
+		if (!o[0]->isActive() && !o[1]->isActive() && !o[2]->isActive() && !o[3]->isActive()) {
+			chan.feedbuf[2] = 0;
+			continue;
+		}
+
+		int32 *output = _chanBuffer;
+
+		switch (chan.algorithm) {
+		case 0:
+			generateChannelOutput<0>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 1:
+			generateChannelOutput<1>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 2:
+			generateChannelOutput<2>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 3:
+			generateChannelOutput<3>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 4:
+			generateChannelOutput<4>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 5:
+			generateChannelOutput<5>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 6:
+			generateChannelOutput<6>(o, chan.feedbuf, output, bufferSize);
+			break;
+		case 7:
+			generateChannelOutput<7>(o, chan.feedbuf, output, bufferSize);
+			break;
+		};
+
+		const bool applyVolumeA = ((1 << i) & _volMaskA) != 0;
+		const bool applyVolumeB = ((1 << i) & _volMaskB) != 0;
+		int32 *leftSample = chan.enableLeft ? buffer : 0;
+		int32 *rightSample = chan.enableRight ? buffer + 1 : 0;
+
+		for (uint32 ii = 0; ii < bufferSize; ii++) {
+			int32 finOut = (output[ii] << 2) / divisor;
+
+			if (applyVolumeA)
 				finOut = (finOut * _volumeA) / Audio::Mixer::kMaxMixerVolume;
 
-			if ((1 << i) & _volMaskB)
+			if (applyVolumeB)
 				finOut = (finOut * _volumeB) / Audio::Mixer::kMaxMixerVolume;
 
-			if (_chanInternal[i].enableLeft)
-				*leftSample += finOut;
+			if (leftSample)
+				leftSample[ii << 1] += finOut;
 
-			if (_chanInternal[i].enableRight)
-				*rightSample += finOut;
+			if (rightSample)
+				rightSample[ii << 1] += finOut;
 		}
 	}
 }
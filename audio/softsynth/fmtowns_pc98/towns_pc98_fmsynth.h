@@ -167,6 +167,12 @@ private:
 	int _volMaskA, _volMaskB;
 	uint16 _volumeA, _volumeB;
 
+	// Mixing buffer of readBuffer and output buffer for a single fm channel,
+	// kept around between calls so that rendering doesn't allocate.
+	int32 *_renderBuffer;
+	int32 *_chanBuffer;
+	int _renderBufferSize;
+
 	const float _baserate;
 	uint32 _timerbase;
 	uint32 _rtt;
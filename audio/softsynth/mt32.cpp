@@ -37,7 +37,9 @@
 #include "common/error.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
+#include "common/timer.h"
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
@@ -102,6 +104,35 @@ private:
 
 	int _outputRate;
 
+	// Guards the synth against MIDI arriving while it renders
+	Common::Mutex _synthMutex;
+	// Whether MIDI arrived since the last render
+	bool _midiPending;
+
+	// Render-ahead state. When enabled, a timer proc keeps _latency frames
+	// of rendered output in _ringBuffer, running the player callback at the
+	// exact sample position it would have been run at by readBuffer(). The
+	// mixer callback then only copies samples out of the ring buffer.
+	enum {
+		FIXP_SHIFT = 16
+	};
+
+	Common::Mutex _bufferMutex;
+	int16 *_ringBuffer;
+	uint _ringSize;
+	uint _latency;
+	uint _readPos, _writePos;
+	uint _filled;
+	uint _underruns;
+
+	Common::TimerManager::TimerProc _timerProc;
+	void *_timerParam;
+	int _nextTick;
+	int _samplesPerTick;
+
+	static void renderAheadProc(void *refCon);
+	void fillRingBuffer();
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -114,14 +145,17 @@ public:
 	int open();
 	void close();
 	void send(uint32 b);
+	void sendBatch(const uint32 *events, uint count);
 	void setPitchBendRange (byte channel, uint range);
 	void sysEx(const byte *msg, uint16 length);
 
 	uint32 property(int prop, uint32 param);
 	MidiChannel *allocateChannel();
 	MidiChannel *getPercussionChannel();
+	void setTimerCallback(void *timer_param, Common::TimerManager::TimerProc timer_proc);
 
 	// AudioStream API
+	int readBuffer(int16 *data, const int numSamples);
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
 };
@@ -142,6 +176,18 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_synth = NULL;
 	_outputRate = 0;
 	_initializing = false;
+	_midiPending = false;
+
+	_ringBuffer = NULL;
+	_ringSize = 0;
+	_latency = 0;
+	_readPos = _writePos = 0;
+	_filled = 0;
+	_underruns = 0;
+	_timerProc = NULL;
+	_timerParam = NULL;
+	_nextTick = 0;
+	_samplesPerTick = 0;
 
 	// Initialized in open()
 	_controlROM = NULL;
@@ -171,6 +217,9 @@ void MidiDriver_MT32::deleteMuntStructures() {
 	_controlFile = NULL;
 	delete _pcmFile;
 	_pcmFile = NULL;
+
+	delete[] _ringBuffer;
+	_ringBuffer = NULL;
 }
 
 int MidiDriver_MT32::open() {
@@ -221,6 +270,33 @@ int MidiDriver_MT32::open() {
 	_outputRate = _synth->getStereoOutputSampleRate();
 	MidiDriver_Emulated::open();
 
+	// With a non-zero latency, the synth renders ahead of the mixer. MIDI
+	// sent from the player callback is still played at the right sample
+	// position, as Munt timestamps it with the position rendering has
+	// reached, but it is heard that much later.
+	int latency = CLIP(ConfMan.getInt("mt32_latency"), 0, 1000);
+	_latency = (uint)latency * _outputRate / 1000;
+	if (_latency) {
+		_ringSize = 1;
+		while (_ringSize < _latency)
+			_ringSize <<= 1;
+		_ringBuffer = new int16[_ringSize * 2];
+		_readPos = _writePos = 0;
+		_filled = 0;
+		_underruns = 0;
+
+		int d = _outputRate / _baseFreq;
+		int r = _outputRate % _baseFreq;
+		_samplesPerTick = (d << FIXP_SHIFT) + (r << FIXP_SHIFT) / _baseFreq;
+		_nextTick = 0;
+
+		// Prime the buffer before the mixer starts pulling from it, then
+		// top it up twice per latency period.
+		fillRingBuffer();
+		g_system->getTimerManager()->installTimerProc(&renderAheadProc, latency * 1000 / 2, this, "MT32renderAhead");
+		debug(1, "MT32: Rendering %d ms ahead", latency);
+	}
+
 	_initializing = false;
 
 	if (screenFormat.bytesPerPixel > 1)
@@ -236,9 +312,18 @@ int MidiDriver_MT32::open() {
 }
 
 void MidiDriver_MT32::send(uint32 b) {
+	Common::StackLock lock(_synthMutex);
+	_midiPending = true;
 	_synth->playMsg(b);
 }
 
+void MidiDriver_MT32::sendBatch(const uint32 *events, uint count) {
+	Common::StackLock lock(_synthMutex);
+	_midiPending = true;
+	for (uint i = 0; i < count; ++i)
+		_synth->playMsg(events[i]);
+}
+
 void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	if (range > 24) {
 		warning("setPitchBendRange() called with range > 24: %d", range);
@@ -257,6 +342,8 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
+	Common::StackLock lock(_synthMutex);
+	_midiPending = true;
 	if (msg[0] == 0xf0) {
 		_synth->playSysex(msg, length);
 	} else {
@@ -269,6 +356,13 @@ void MidiDriver_MT32::close() {
 		return;
 	_isOpen = false;
 
+	// Stop rendering ahead before anything it uses goes away
+	if (_ringBuffer) {
+		g_system->getTimerManager()->removeTimerProc(&renderAheadProc);
+		if (_underruns)
+			warning("MT32: Render-ahead buffer ran dry %u times, consider raising mt32_latency", _underruns);
+	}
+
 	// Detach the player callback handler
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
@@ -279,9 +373,93 @@ void MidiDriver_MT32::close() {
 }
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	Common::StackLock lock(_synthMutex);
+
+	// Skip emulating the synth while it is silent and nothing is queued for
+	// it, e.g. while the music plays from the music cache. MIDI sent later is
+	// timestamped with the position rendering stopped at, so it still plays
+	// at the start of the next render.
+	if (!_midiPending && !_synth->isActive()) {
+		memset(data, 0, len * 2 * sizeof(int16));
+		return;
+	}
+
+	_midiPending = false;
 	_synth->render(data, len);
 }
 
+void MidiDriver_MT32::setTimerCallback(void *timer_param, Common::TimerManager::TimerProc timer_proc) {
+	_timerProc = timer_proc;
+	_timerParam = timer_param;
+	MidiDriver_Emulated::setTimerCallback(timer_param, timer_proc);
+}
+
+int MidiDriver_MT32::readBuffer(int16 *data, const int numSamples) {
+	if (!_ringBuffer)
+		return MidiDriver_Emulated::readBuffer(data, numSamples);
+
+	Common::StackLock lock(_bufferMutex);
+
+	uint len = numSamples / 2;
+	const uint avail = MIN(len, _filled);
+	uint copied = 0;
+	while (copied < avail) {
+		const uint step = MIN(avail - copied, _ringSize - _readPos);
+		memcpy(data + copied * 2, _ringBuffer + _readPos * 2, step * 2 * sizeof(int16));
+		_readPos = (_readPos + step) & (_ringSize - 1);
+		copied += step;
+	}
+	_filled -= avail;
+
+	if (avail < len) {
+		// Rendering fell behind. Play silence rather than block the mixer,
+		// the render position simply slips by the missing amount.
+		memset(data + avail * 2, 0, (len - avail) * 2 * sizeof(int16));
+		++_underruns;
+		debug(1, "MT32: Render-ahead buffer underrun, %u of %u samples missing", len - avail, len);
+	}
+
+	return numSamples;
+}
+
+void MidiDriver_MT32::renderAheadProc(void *refCon) {
+	((MidiDriver_MT32 *)refCon)->fillRingBuffer();
+}
+
+void MidiDriver_MT32::fillRingBuffer() {
+	for (;;) {
+		uint space;
+		{
+			Common::StackLock lock(_bufferMutex);
+			space = _latency - _filled;
+		}
+		if (!space)
+			break;
+
+		// The region past _writePos is never touched by readBuffer(), so it
+		// can be rendered into without holding the buffer mutex.
+		uint step = MIN(space, _ringSize - _writePos);
+		step = MIN(step, (uint)(_nextTick >> FIXP_SHIFT));
+		if (step) {
+			generateSamples(_ringBuffer + _writePos * 2, step);
+			recordSamples(_ringBuffer + _writePos * 2, step * 2);
+			_writePos = (_writePos + step) & (_ringSize - 1);
+
+			Common::StackLock lock(_bufferMutex);
+			_filled += step;
+		}
+
+		// Run the player callback without holding either mutex, as it calls
+		// back into send() and may take locks of its own.
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+			_nextTick += _samplesPerTick;
+		}
+	}
+}
+
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 	switch (prop) {
 	case PROP_CHANNEL_MASK:
@@ -311,121 +489,6 @@ MidiChannel *MidiDriver_MT32::getPercussionChannel() {
 	return &_midiChannels[9];
 }
 
-// This code should be used when calling the timer callback from the mixer thread is undesirable.
-// Note that it results in less accurate timing.
-#if 0
-class MidiEvent_MT32 {
-public:
-	MidiEvent_MT32 *_next;
-	uint32 _msg; // 0xFFFFFFFF indicates a sysex message
-	byte *_data;
-	uint32 _len;
-
-	MidiEvent_MT32(uint32 msg, byte *data, uint32 len) {
-		_msg = msg;
-		if (len > 0) {
-			_data = new byte[len];
-			memcpy(_data, data, len);
-		}
-		_len = len;
-		_next = NULL;
-	}
-
-	MidiEvent_MT32() {
-		if (_len > 0)
-			delete _data;
-	}
-};
-
-class MidiDriver_ThreadedMT32 : public MidiDriver_MT32 {
-private:
-	OSystem::Mutex _eventMutex;
-	MidiEvent_MT32 *_events;
-	TimerManager::TimerProc _timer_proc;
-
-	void pushMidiEvent(MidiEvent_MT32 *event);
-	MidiEvent_MT32 *popMidiEvent();
-
-protected:
-	void send(uint32 b);
-	void sysEx(const byte *msg, uint16 length);
-
-public:
-	MidiDriver_ThreadedMT32(Audio::Mixer *mixer);
-
-	void onTimer();
-	void close();
-	void setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc);
-};
-
-
-MidiDriver_ThreadedMT32::MidiDriver_ThreadedMT32(Audio::Mixer *mixer) : MidiDriver_MT32(mixer) {
-	_events = NULL;
-	_timer_proc = NULL;
-}
-
-void MidiDriver_ThreadedMT32::close() {
-	MidiDriver_MT32::close();
-	while ((popMidiEvent() != NULL)) {
-		// Just eat any leftover events
-	}
-}
-
-void MidiDriver_ThreadedMT32::setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc) {
-	if (!_timer_proc || !timer_proc) {
-		if (_timer_proc)
-			_vm->_timer->removeTimerProc(_timer_proc);
-		_timer_proc = timer_proc;
-		if (timer_proc)
-			_vm->_timer->installTimerProc(timer_proc, getBaseTempo(), timer_param, "MT32tempo");
-	}
-}
-
-void MidiDriver_ThreadedMT32::pushMidiEvent(MidiEvent_MT32 *event) {
-	Common::StackLock lock(_eventMutex);
-	if (_events == NULL) {
-		_events = event;
-	} else {
-		MidiEvent_MT32 *last = _events;
-		while (last->_next != NULL)
-			last = last->_next;
-		last->_next = event;
-	}
-}
-
-MidiEvent_MT32 *MidiDriver_ThreadedMT32::popMidiEvent() {
-	Common::StackLock lock(_eventMutex);
-	MidiEvent_MT32 *event;
-	event = _events;
-	if (event != NULL)
-		_events = event->_next;
-	return event;
-}
-
-void MidiDriver_ThreadedMT32::send(uint32 b) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(b, NULL, 0);
-	pushMidiEvent(event);
-}
-
-void MidiDriver_ThreadedMT32::sysEx(const byte *msg, uint16 length) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(0xFFFFFFFF, msg, length);
-	pushMidiEvent(event);
-}
-
-void MidiDriver_ThreadedMT32::onTimer() {
-	MidiEvent_MT32 *event;
-	while ((event = popMidiEvent()) != NULL) {
-		if (event->_msg == 0xFFFFFFFF) {
-			MidiDriver_MT32::sysEx(event->_data, event->_len);
-		} else {
-			MidiDriver_MT32::send(event->_msg);
-		}
-		delete event;
-	}
-}
-#endif
-
-
 // Plugin interface
 
 class MT32EmuMusicPlugin : public MusicPluginObject {
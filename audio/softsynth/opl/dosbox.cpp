@@ -145,7 +145,7 @@ uint8 Chip::read() {
 	return ret;
 }
 
-OPL::OPL(Config::OplType type) : _type(type), _rate(0), _emulator(0) {
+OPL::OPL(Config::OplType type) : EmulatedOPL(true), _type(type), _rate(0), _emulator(0), _opl3Active(false) {
 }
 
 OPL::~OPL() {
@@ -163,6 +163,7 @@ bool OPL::init() {
 
 	memset(&_reg, 0, sizeof(_reg));
 	memset(_chip, 0, sizeof(_chip));
+	clearWrites();
 
 	_emulator = new DBOPL::Chip();
 	if (!_emulator)
@@ -176,6 +177,7 @@ bool OPL::init() {
 		// Setup opl3 mode in the hander
 		_emulator->WriteReg(0x105, 1);
 	}
+	_opl3Active = _emulator->opl3Active != 0;
 
 	return true;
 }
@@ -190,7 +192,7 @@ void OPL::write(int port, int val) {
 		case Config::kOpl2:
 		case Config::kOpl3:
 			if (!_chip[0].write(_reg.normal, val))
-				_emulator->WriteReg(_reg.normal, val);
+				emulatorWrite(_reg.normal, val);
 			break;
 		case Config::kDualOpl2:
 			// Not a 0x??8 port, then write to a specific port
@@ -209,10 +211,10 @@ void OPL::write(int port, int val) {
 		// Make sure to clip them in the right range
 		switch (_type) {
 		case Config::kOpl2:
-			_reg.normal = _emulator->WriteAddr(port, val) & 0xff;
+			_reg.normal = emulatorAddr(port, val) & 0xff;
 			break;
 		case Config::kOpl3:
-			_reg.normal = _emulator->WriteAddr(port, val) & 0x1ff;
+			_reg.normal = emulatorAddr(port, val) & 0x1ff;
 			break;
 		case Config::kDualOpl2:
 			// Not a 0x?88 port, when write to a specific side
@@ -306,7 +308,35 @@ void OPL::dualWrite(uint8 index, uint8 reg, uint8 val) {
 	}
 
 	uint32 fullReg = reg + (index ? 0x100 : 0);
-	_emulator->WriteReg(fullReg, val);
+	emulatorWrite(fullReg, val);
+}
+
+void OPL::emulatorWrite(uint32 reg, uint8 val) {
+	// The emulator only sees the write once rendering catches up with it,
+	// but the address decoding below depends on the OPL3 mode right away.
+	if (reg == 0x105)
+		_opl3Active = (val & 1) != 0;
+
+	queueWrite(reg, val);
+}
+
+uint32 OPL::emulatorAddr(int port, uint8 val) const {
+	// Same as DBOPL::Chip::WriteAddr, using the OPL3 mode of the queued
+	// writes instead of the emulator's
+	switch (port & 3) {
+	case 0:
+		return val;
+	case 2:
+		if (_opl3Active || (val == 0x05))
+			return 0x100 | val;
+		else
+			return val;
+	}
+	return 0;
+}
+
+void OPL::applyWrite(uint reg, uint8 value) {
+	_emulator->WriteReg(reg, value);
 }
 
 void OPL::generateSamples(int16 *buffer, int length) {
@@ -81,8 +81,13 @@ private:
 		uint8 dual[2];
 	} _reg;
 
+	// Whether OPL3 mode is enabled, as of the last queued write
+	bool _opl3Active;
+
 	void free();
 	void dualWrite(uint8 index, uint8 reg, uint8 val);
+	void emulatorWrite(uint32 reg, uint8 val);
+	uint32 emulatorAddr(int port, uint8 val) const;
 public:
 	OPL(Config::OplType type);
 	~OPL();
@@ -99,6 +104,7 @@ public:
 
 protected:
 	void generateSamples(int16 *buffer, int length);
+	void applyWrite(uint reg, uint8 value);
 };
 
 } // End of namespace DOSBox
@@ -75,6 +75,9 @@ bool DefaultAudioCDManager::play(int track, int numLoops, int startFrame, int du
 			stream = Audio::SeekableAudioStream::openStreamFile(trackName[i]);
 
 		if (stream != 0) {
+			// Keep compressed tracks decoded ahead of the mixer
+			stream = Audio::makeDecodeAheadStream(stream, 1000);
+
 			Audio::Timestamp start = Audio::Timestamp(0, startFrame, 75);
 			Audio::Timestamp end = duration ? Audio::Timestamp(0, startFrame + duration, 75) : stream->getLength();
 
@@ -0,0 +1,58 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef BACKENDS_FS_POSIX_POSIX_MAPPED_STREAM_H
+#define BACKENDS_FS_POSIX_POSIX_MAPPED_STREAM_H
+
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+#include <unistd.h>
+
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#define POSIX_MAPPED_STREAM
+
+/**
+ * A read only stream over a file which is mapped into memory with mmap().
+ * Its data is available through getMemory(), and pages are only read from
+ * disk when they are first accessed.
+ */
+class PosixMappedStream : public Common::MemoryReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Given a path, maps the file at that path into memory and wraps it in
+	 * a PosixMappedStream instance. Returns 0 if the file can't be mapped,
+	 * which is always the case for empty files.
+	 */
+	static PosixMappedStream *makeFromPath(const Common::String &path);
+
+	virtual ~PosixMappedStream();
+
+private:
+	PosixMappedStream(const byte *data, uint32 size);
+};
+
+#endif
+
+#endif
@@ -25,9 +25,11 @@
 
 #include "backends/graphics/opengl/opengl-sys.h"
 
+#include "graphics/microtiles.h"
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace OpenGL {
@@ -201,7 +203,7 @@ public:
 	void fill(uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyTiles.isEmpty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -239,12 +241,26 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyTiles.clear(); }
 
+	/**
+	 * @return The bounding rectangle of all dirty areas.
+	 */
 	Common::Rect getDirtyArea() const;
+
+	/**
+	 * Obtain the dirty areas of the surface. The areas do not overlap.
+	 */
+	void getDirtyAreas(Common::Array<Common::Rect> &areas) const;
+
+	/**
+	 * Obtain the dirty areas of the surface joined into bands of rows, as
+	 * uploaded by GLTexture::updateArea. The bands do not overlap.
+	 */
+	void getDirtyBands(Common::Array<Common::Rect> &bands) const;
 private:
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Graphics::MicroTileArray _dirtyTiles;
 };
 
 /**
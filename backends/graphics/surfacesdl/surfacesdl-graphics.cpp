@@ -138,7 +138,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_overlayVisible(false),
 	_overlayscreen(0), _tmpscreen2(0),
-	_scalerProc(0), _screenChangeCount(0),
+	_scalerProc(0), _scalerReentrant(true), _screenChangeCount(0),
 	_mouseVisible(false), _mouseNeedsRedraw(false), _mouseData(0), _mouseSurface(0),
 	_mouseOrigSurface(0), _cursorDontScale(false), _cursorPaletteDisabled(true),
 	_currentShakePos(0), _newShakePos(0),
@@ -189,6 +189,16 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #else
 	_videoMode.fullscreen = true;
 #endif
+
+	// Use one scaler thread per CPU, where SDL can tell how many there are
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int scalerThreads = SDL_GetCPUCount();
+#else
+	int scalerThreads = 1;
+#endif
+	if (ConfMan.hasKey("scaler_threads"))
+		scalerThreads = ConfMan.getInt("scaler_threads");
+	_scalerThreads.setThreadCount(scalerThreads);
 }
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
@@ -566,6 +576,7 @@ bool SurfaceSdlGraphicsManager::setGraphicsMode(int mode) {
 void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	Common::StackLock lock(_graphicsMutex);
 	ScalerProc *newScalerProc = 0;
+	bool reentrant = true;
 
 	switch (_videoMode.mode) {
 	case GFX_NORMAL:
@@ -597,9 +608,16 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 #ifdef USE_HQ_SCALERS
 	case GFX_HQ2X:
 		newScalerProc = HQ2x;
+#ifdef USE_NASM
+		// The 16bpp assembly keeps its loop state in global variables
+		reentrant = false;
+#endif
 		break;
 	case GFX_HQ3X:
 		newScalerProc = HQ3x;
+#ifdef USE_NASM
+		reentrant = false;
+#endif
 		break;
 #endif
 	case GFX_TV2X:
@@ -615,6 +633,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	}
 
 	_scalerProc = newScalerProc;
+	_scalerReentrant = reentrant;
 
 	if (_videoMode.mode != GFX_NORMAL) {
 		for (int i = 0; i < ARRAYSIZE(s_gfxModeSwitchTable); i++) {
@@ -1030,6 +1049,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
 	ScalerProc *scalerProc;
+	bool scalerReentrant;
 	int scale1;
 
 	// definitions not available for non-DEBUG here. (needed this to compile in SYMBIAN32 & linux?)
@@ -1103,6 +1123,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		width = _videoMode.screenWidth;
 		height = _videoMode.screenHeight;
 		scalerProc = _scalerProc;
+		scalerReentrant = _scalerReentrant;
 		scale1 = _videoMode.scaleFactor;
 	} else {
 		origSurf = _overlayscreen;
@@ -1110,6 +1131,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		width = _videoMode.overlayWidth;
 		height = _videoMode.overlayHeight;
 		scalerProc = Normal1x;
+		scalerReentrant = true;
 
 		scale1 = 1;
 	}
@@ -1119,6 +1141,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	// Move the merged screen updates to the list of dirty rects
+	extractDirtyRects();
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -1172,7 +1197,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+				_scalerThreads.scale(scalerProc, scalerReentrant, scale1, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
 			}
 
@@ -1422,11 +1447,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceFull = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1465,25 +1485,72 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		h = height - y;
 	}
 
-#ifdef USE_SCALERS
-	if (_videoMode.aspectRatioCorrection && !_overlayVisible && !realCoordinates) {
-		makeRectStretchable(x, y, w, h);
+	if (w == width && h == height) {
+		_forceFull = true;
+		return;
 	}
-#endif
 
-	if (w == width && h == height) {
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (!realCoordinates) {
+		// Screen and overlay updates are merged in the tile array. They are
+		// extracted, and aspect ratio corrected, by extractDirtyRects().
+		if (_dirtyTiles.getWidth() != width || _dirtyTiles.getHeight() != height) {
+			// The pending areas belong to a screen of another size
+			if (!_dirtyTiles.isEmpty())
+				_forceFull = true;
+			_dirtyTiles.resize(width, height);
+			if (_forceFull)
+				return;
+		}
+
+		_dirtyTiles.addRect(Common::Rect(x, y, x + w, y + h));
+		return;
+	}
+
+	if (_numDirtyRects == NUM_DIRTY_RECT) {
 		_forceFull = true;
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+	r->x = x;
+	r->y = y;
+	r->w = w;
+	r->h = h;
+}
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+void SurfaceSdlGraphicsManager::extractDirtyRects() {
+	if (!_forceFull && !_dirtyTiles.isEmpty()) {
+		_dirtyTileRects.resize(0);
+		_dirtyTiles.getRectangles(_dirtyTileRects);
+
+		if (_numDirtyRects + (int)_dirtyTileRects.size() > NUM_DIRTY_RECT) {
+			_forceFull = true;
+		} else {
+			for (uint i = 0; i < _dirtyTileRects.size(); ++i) {
+				const Common::Rect &rect = _dirtyTileRects[i];
+				int x = rect.left, y = rect.top, w = rect.width(), h = rect.height();
+
+#ifdef USE_SCALERS
+				if (_videoMode.aspectRatioCorrection && !_overlayVisible) {
+					makeRectStretchable(x, y, w, h);
+				}
+#endif
+
+				SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+				r->x = x;
+				r->y = y;
+				r->w = w;
+				r->h = h;
+			}
+		}
 	}
+
+	_dirtyTiles.clear();
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() {
@@ -25,6 +25,8 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scalerthreads.h"
+#include "graphics/microtiles.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -282,7 +284,12 @@ protected:
 	bool _forceFull;
 
 	ScalerProc *_scalerProc;
+	/** Whether _scalerProc may run on several threads at once */
+	bool _scalerReentrant;
 	int _scalerType;
+
+	/** Splits large dirty rects into bands which are scaled in parallel */
+	SdlScalerThreads _scalerThreads;
 	int _transactionMode;
 
 	// Indicates whether it is needed to free _hwsurface in destructor
@@ -301,6 +308,8 @@ protected:
 	// Dirty rect management
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
+	Graphics::MicroTileArray _dirtyTiles;
+	Common::Array<Common::Rect> _dirtyTileRects;
 
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
@@ -372,6 +381,13 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	/**
+	 * Appends the merged screen updates to the list of dirty rects, switching
+	 * to a full redraw if they do not fit. Call once per frame, before the
+	 * list is used.
+	 */
+	void extractDirtyRects();
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
@@ -0,0 +1,145 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerthreads.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+SdlScalerThreads::SdlScalerThreads()
+	: _workerCount(0), _done(0), _quit(false) {
+}
+
+SdlScalerThreads::~SdlScalerThreads() {
+	stopWorkers();
+}
+
+void SdlScalerThreads::setThreadCount(int count) {
+	count = CLIP<int>(count, 1, kMaxThreads);
+	if (count == _workerCount + 1)
+		return;
+
+	stopWorkers();
+
+	if (count == 1)
+		return;
+
+	_done = SDL_CreateSemaphore(0);
+	_quit = false;
+
+	for (int i = 0; i < count - 1; ++i) {
+		Worker &worker = _workers[i];
+		worker.owner = this;
+		worker.start = SDL_CreateSemaphore(0);
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		worker.thread = SDL_CreateThread(workerThreadEntry, "ScummVM Scaler", &worker);
+#else
+		worker.thread = SDL_CreateThread(workerThreadEntry, &worker);
+#endif
+		if (!worker.thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			SDL_DestroySemaphore(worker.start);
+			break;
+		}
+		_workerCount++;
+	}
+}
+
+void SdlScalerThreads::stopWorkers() {
+	if (!_done)
+		return;
+
+	// Wake up all workers, they quit instead of scaling
+	_quit = true;
+	for (int i = 0; i < _workerCount; ++i)
+		SDL_SemPost(_workers[i].start);
+
+	for (int i = 0; i < _workerCount; ++i) {
+		SDL_WaitThread(_workers[i].thread, NULL);
+		SDL_DestroySemaphore(_workers[i].start);
+	}
+
+	SDL_DestroySemaphore(_done);
+	_done = 0;
+	_workerCount = 0;
+}
+
+void SdlScalerThreads::scale(ScalerProc *scalerProc, bool reentrant, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+                             uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	const int bandCount = MIN<int>(MIN<int>(_workerCount + 1, height / 2), width * height / kMinBandPixels);
+	if (bandCount <= 1 || !reentrant) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	// Some scalers (Normal1o5x, DotMatrix) work on pairs of rows, so all
+	// bands but the last one need an even height. Rounding up makes sure
+	// the rect never needs more than bandCount bands.
+	const int bandHeight = ((height + bandCount - 1) / bandCount + 1) & ~1;
+
+	// The calling thread scales the first band, the workers the others
+	int busyWorkers = 0;
+	for (int y = bandHeight; y < height && busyWorkers < _workerCount; y += bandHeight) {
+		Band &band = _workers[busyWorkers].band;
+		band.scalerProc = scalerProc;
+		band.srcPtr = srcPtr + y * srcPitch;
+		band.srcPitch = srcPitch;
+		band.dstPtr = dstPtr + y * scaleFactor * dstPitch;
+		band.dstPitch = dstPitch;
+		band.width = width;
+		band.height = MIN(bandHeight, height - y);
+
+		SDL_SemPost(_workers[busyWorkers].start);
+		busyWorkers++;
+	}
+	assert(busyWorkers <= _workerCount && busyWorkers * bandHeight + bandHeight >= height);
+
+	scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, MIN(bandHeight, height));
+
+	while (busyWorkers--)
+		SDL_SemWait(_done);
+}
+
+void SdlScalerThreads::workerThread(Worker *worker) {
+	while (true) {
+		SDL_SemWait(worker->start);
+		if (_quit)
+			break;
+
+		const Band &band = worker->band;
+		band.scalerProc(band.srcPtr, band.srcPitch, band.dstPtr, band.dstPitch, band.width, band.height);
+
+		SDL_SemPost(_done);
+	}
+}
+
+int SDLCALL SdlScalerThreads::workerThreadEntry(void *arg) {
+	Worker *worker = (Worker *)arg;
+	assert(worker);
+	worker->owner->workerThread(worker);
+	return 0;
+}
+
+#endif
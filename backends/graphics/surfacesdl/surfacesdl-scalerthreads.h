@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALERTHREADS_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALERTHREADS_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "graphics/scaler.h"
+
+/**
+ * Runs a scaler over large areas in parallel, by splitting them into
+ * horizontal bands which are handed to a set of worker threads.
+ *
+ * This is safe because the scalers only read the source rows around the
+ * area they scale, and only write the destination rows of that area. Only
+ * the HQ scalers' NASM versions keep state outside their stack, which
+ * makes them unsafe to run on several threads.
+ */
+class SdlScalerThreads {
+public:
+	SdlScalerThreads();
+	~SdlScalerThreads();
+
+	/**
+	 * Set the number of threads used for scaling, including the calling
+	 * thread. A count of 1 disables parallel scaling.
+	 */
+	void setThreadCount(int count);
+	int getThreadCount() const { return _workerCount + 1; }
+
+	/**
+	 * Scale an area. The parameters are the same as those of ScalerProc,
+	 * scaleFactor is the number of destination rows per source row.
+	 * Scalers which are not reentrant scale the whole area on the calling
+	 * thread.
+	 */
+	void scale(ScalerProc *scalerProc, bool reentrant, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+	           uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
+private:
+	enum {
+		kMaxThreads = 8,
+		kMinBandPixels = 320 * 32	///< Minimal number of source pixels per band
+	};
+
+	struct Band {
+		ScalerProc *scalerProc;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width;
+		int height;
+	};
+
+	struct Worker {
+		SdlScalerThreads *owner;
+		SDL_Thread *thread;
+		SDL_sem *start;
+		Band band;
+	};
+
+	Worker _workers[kMaxThreads - 1];
+	int _workerCount;
+	SDL_sem *_done;
+	bool _quit;
+
+	void stopWorkers();
+
+	/**
+	 * Scales the bands handed to a worker, until asked to quit
+	 */
+	void workerThread(Worker *worker);
+
+	/**
+	 * Entry point for the worker threads
+	 */
+	static int SDLCALL workerThreadEntry(void *arg);
+};
+
+#endif
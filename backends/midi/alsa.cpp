@@ -74,9 +74,11 @@ public:
 	bool isOpen() const { return _isOpen; }
 	void close();
 	void send(uint32 b);
+	void sendBatch(const uint32 *events, uint count);
 	void sysEx(const byte *msg, uint16 length);
 
 private:
+	void queueEvent(uint32 b);
 	void send_event(int do_flush);
 	bool _isOpen;
 	snd_seq_event_t ev;
@@ -186,6 +188,24 @@ void MidiDriver_ALSA::send(uint32 b) {
 		return;
 	}
 
+	queueEvent(b);
+	snd_seq_flush_output(seq_handle);
+}
+
+void MidiDriver_ALSA::sendBatch(const uint32 *events, uint count) {
+	if (!_isOpen) {
+		warning("MidiDriver_ALSA: Got event while not open");
+		return;
+	}
+
+	// The sequencer drains its output buffer by itself if it fills up, so
+	// the whole batch goes out with a single flush
+	for (uint i = 0; i < count; ++i)
+		queueEvent(events[i]);
+	snd_seq_flush_output(seq_handle);
+}
+
+void MidiDriver_ALSA::queueEvent(uint32 b) {
 	unsigned int midiCmd[4];
 	ev.type = SND_SEQ_EVENT_OSS;
 
@@ -201,15 +221,15 @@ void MidiDriver_ALSA::send(uint32 b) {
 	switch (midiCmd[0] & 0xF0) {
 	case 0x80:
 		snd_seq_ev_set_noteoff(&ev, chanID, midiCmd[1], midiCmd[2]);
-		send_event(1);
+		send_event(0);
 		break;
 	case 0x90:
 		snd_seq_ev_set_noteon(&ev, chanID, midiCmd[1], midiCmd[2]);
-		send_event(1);
+		send_event(0);
 		break;
 	case 0xA0:
 		snd_seq_ev_set_keypress(&ev, chanID, midiCmd[1], midiCmd[2]);
-		send_event(1);
+		send_event(0);
 		break;
 	case 0xB0:
 		/* is it this simple ? Wow... */
@@ -220,7 +240,7 @@ void MidiDriver_ALSA::send(uint32 b) {
 		if (chanID == 0 && midiCmd[1] == 0x07)
 			_channel0Volume = midiCmd[2];
 
-		send_event(1);
+		send_event(0);
 		break;
 	case 0xC0:
 		snd_seq_ev_set_pgmchange(&ev, chanID, midiCmd[1]);
@@ -230,30 +250,30 @@ void MidiDriver_ALSA::send(uint32 b) {
 		// USB-MIDI cables. If the first MIDI command in a USB packet is a
 		// Cx or Dx command, the second command in the packet is dropped
 		// somewhere.
-		send(0x07B0 | (_channel0Volume << 16));
+		queueEvent(0x07B0 | (_channel0Volume << 16));
 		break;
 	case 0xD0:
 		snd_seq_ev_set_chanpress(&ev, chanID, midiCmd[1]);
-		send_event(1);
+		send_event(0);
 
 		// Send a volume change command to work around a firmware bug in common
 		// USB-MIDI cables. If the first MIDI command in a USB packet is a
 		// Cx or Dx command, the second command in the packet is dropped
 		// somewhere.
-		send(0x07B0 | (_channel0Volume << 16));
+		queueEvent(0x07B0 | (_channel0Volume << 16));
 		break;
 	case 0xE0: {
 		// long theBend = ((((long)midiCmd[1] + (long)(midiCmd[2] << 7))) - 0x2000) / 4;
 		// snd_seq_ev_set_pitchbend(&ev, chanID, theBend);
 		long theBend = ((long)midiCmd[1] + (long)(midiCmd[2] << 7)) - 0x2000;
 		snd_seq_ev_set_pitchbend(&ev, chanID, theBend);
-		send_event(1);
+		send_event(0);
 		} break;
 
 	default:
 		warning("Unknown MIDI Command: %08x", (int)b);
 		/* I don't know if this works but, well... */
-		send_event(1);
+		send_event(0);
 		break;
 	}
 }
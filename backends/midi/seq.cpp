@@ -58,9 +58,12 @@ public:
 	bool isOpen() const { return _isOpen; }
 	void close();
 	void send(uint32 b);
+	void sendBatch(const uint32 *events, uint count);
 	void sysEx(const byte *msg, uint16 length);
 
 private:
+	int encodeEvent(uint32 b, unsigned char *buf);
+
 	bool _isOpen;
 	int device, _device_num;
 };
@@ -109,7 +112,32 @@ void MidiDriver_SEQ::close() {
 }
 
 void MidiDriver_SEQ::send(uint32 b) {
-	unsigned char buf[256];
+	unsigned char buf[12];
+	const int position = encodeEvent(b, buf);
+
+	if (write(device, buf, position) == -1)
+		warning("MidiDriver_SEQ::send: write failed (%s)", strerror(errno));
+}
+
+void MidiDriver_SEQ::sendBatch(const uint32 *events, uint count) {
+	// Each event takes up to 12 bytes
+	unsigned char buf[64 * 12];
+	int position = 0;
+
+	for (uint i = 0; i < count; ++i) {
+		if (position > (int)sizeof(buf) - 12) {
+			if (write(device, buf, position) == -1)
+				warning("MidiDriver_SEQ::sendBatch: write failed (%s)", strerror(errno));
+			position = 0;
+		}
+		position += encodeEvent(events[i], buf + position);
+	}
+
+	if (position && write(device, buf, position) == -1)
+		warning("MidiDriver_SEQ::sendBatch: write failed (%s)", strerror(errno));
+}
+
+int MidiDriver_SEQ::encodeEvent(uint32 b, unsigned char *buf) {
 	int position = 0;
 
 	switch (b & 0xF0) {
@@ -146,8 +174,7 @@ void MidiDriver_SEQ::send(uint32 b) {
 		warning("MidiDriver_SEQ::send: unknown: %08x", (int)b);
 		break;
 	}
-	if (write(device, buf, position) == -1)
-		warning("MidiDriver_SEQ::send: write failed (%s)", strerror(errno));
+	return position;
 }
 
 void MidiDriver_SEQ::sysEx(const byte *msg, uint16 length) {
@@ -143,6 +143,11 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+const byte *File::getMemory() const {
+	assert(_handle);
+	return _handle->getMemory();
+}
+
 
 DumpFile::DumpFile() : _handle(0) {
 }
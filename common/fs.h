@@ -222,6 +222,17 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which keeps the whole file in memory if the
+	 * backend can map it there. Its data can then be accessed without
+	 * copying through SeekableReadStream::getMemory(). Backends which can't
+	 * map files return the same stream as createReadStream() does.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -461,6 +461,17 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Returns a pointer to the data of the whole stream, if the stream
+	 * keeps it in memory. This allows users to access the data without
+	 * copying it through read(). The data stays valid for as long as the
+	 * stream exists, and it is not affected by the stream position.
+	 *
+	 * @return a pointer to size() bytes of data, or 0 if the data is not
+	 *         held in memory
+	 */
+	virtual const byte *getMemory() const { return 0; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
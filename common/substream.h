@@ -77,6 +77,11 @@ public:
 	virtual int32 size() const { return _end - _begin; }
 
 	virtual bool seek(int32 offset, int whence = SEEK_SET);
+
+	virtual const byte *getMemory() const {
+		const byte *memory = _parentStream->getMemory();
+		return memory ? memory + _begin : 0;
+	}
 };
 
 /**
@@ -0,0 +1,210 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+// HACK to allow building with the SDL backend on MinGW
+// see bug #1800764 "TOOLS: MinGW tools building broken"
+#ifdef main
+#undef main
+#endif // main
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/list.h"
+#include "common/system.h"
+#include "graphics/pixelformat.h"
+
+#include <time.h>
+
+namespace {
+
+/**
+ * A headless OSystem. The benchmarked code only needs the time, mutexes
+ * and logging. The benchmarks are single threaded, so mutexes don't
+ * lock anything.
+ */
+class BenchmarkSystem : public OSystem {
+public:
+	virtual const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode noGraphicsModes[] = { { 0, 0, 0 } };
+		return noGraphicsModes;
+	}
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return false; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat::createFormatCLUT8());
+		return formats;
+	}
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+
+	// Processor time, so that other processes don't skew the results
+	virtual uint32 getMillis(bool skipRecord) { return (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC); }
+	virtual void delayMillis(uint msecs) {}
+	virtual void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+
+	virtual MutexRef createMutex() { return (MutexRef)this; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+
+	virtual Audio::Mixer *getMixer() { return 0; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void copyRectToOSD(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual void clearOSD() {}
+	virtual Graphics::PixelFormat getOSDFormat() { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void logMessage(LogMessageType::Type type, const char *message) { fputs(message, stderr); }
+};
+
+struct BenchmarkDesc {
+	const char *name;
+	const char *args;
+	const char *description;
+	BenchmarkProc proc;
+};
+
+const BenchmarkDesc benchmarks[] = {
+#ifdef USE_SCALERS
+	{ "scalers", "", "Time the graphics scalers on synthetic frames", benchmarkScalers },
+#endif
+	{ "blending", "", "Time the sprite blending routines", benchmarkBlending },
+	{ "dirty-rects", "", "Time the dirty rectangle tracking", benchmarkDirtyRects },
+	{ "images", "FILE...", "Time PNG and JPEG decoding of the given images", benchmarkImages },
+	{ "opl", "FILE", "Time the OPL emulators on a DOSBox .dro capture", benchmarkOPL },
+	{ "adpcm", "", "Time the ADPCM decoders on a synthetic voice track", benchmarkADPCM },
+	{ "paula", "", "Time the Amiga sound chip emulation", benchmarkPaula },
+	{ "fmtowns", "[FRAMES]", "Time the FM-Towns/PC-98 sound chip emulation", benchmarkFMTowns },
+	{ 0, 0, 0, 0 }
+};
+
+void printUsage(const char *appName) {
+	printf("Usage: %s BENCHMARK [ARGS]...\n\n", appName);
+	for (const BenchmarkDesc *benchmark = benchmarks; benchmark->name; ++benchmark) {
+		char usage[64];
+		snprintf(usage, sizeof(usage), "%s %s", benchmark->name, benchmark->args);
+		printf("  %-26s %s\n", usage, benchmark->description);
+	}
+}
+
+} // End of anonymous namespace
+
+byte *loadFile(const char *filename, uint32 &size) {
+	FILE *file = fopen(filename, "rb");
+	if (!file) {
+		printf("Could not open '%s'\n", filename);
+		return 0;
+	}
+
+	byte *data = 0;
+	if (!fseek(file, 0, SEEK_END)) {
+		const long length = ftell(file);
+		if (length >= 0 && !fseek(file, 0, SEEK_SET)) {
+			size = length;
+			data = new byte[size];
+			if (fread(data, 1, size, file) != size) {
+				delete[] data;
+				data = 0;
+			}
+		}
+	}
+
+	fclose(file);
+	if (!data)
+		printf("Could not read '%s'\n", filename);
+	return data;
+}
+
+void printTableHeader(const char *header) {
+	printf("%s\n", header);
+	// Columns are separated by two spaces or more, single spaces are part
+	// of the column title
+	for (const char *c = header; *c; ++c) {
+		const bool separator = *c == ' ' && (c == header || c[-1] == ' ' || c[1] == ' ' || !c[1]);
+		putchar(separator ? ' ' : '-');
+	}
+	putchar('\n');
+}
+
+double BenchmarkLoop::measure(uint32 minTime) {
+	uint32 runs = 0;
+	const uint32 start = g_system->getMillis();
+	uint32 elapsed;
+	do {
+		run();
+		++runs;
+		elapsed = g_system->getMillis() - start;
+	} while (elapsed < minTime);
+
+	return (double)elapsed / runs;
+}
+
+uint32 BenchmarkLoop::measureOnce() {
+	const uint32 start = g_system->getMillis();
+	run();
+	return MAX<uint32>(g_system->getMillis() - start, 1);
+}
+
+int main(int argc, char *argv[]) {
+	const BenchmarkDesc *benchmark = benchmarks;
+	while (benchmark->name && (argc < 2 || strcmp(argv[1], benchmark->name)))
+		++benchmark;
+
+	bool validArgs = false;
+	if (benchmark->name) {
+		BenchmarkSystem system;
+		g_system = &system;
+		validArgs = benchmark->proc(argc - 2, argv + 2);
+		g_system = 0;
+	}
+
+	if (!validArgs) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef DEVTOOLS_BENCHMARK_BENCHMARK_H
+#define DEVTOOLS_BENCHMARK_BENCHMARK_H
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+/**
+ * Runs a benchmark with the arguments given after its name on the command
+ * line. Returns false if the arguments are not valid.
+ */
+typedef bool (*BenchmarkProc)(int argc, char *argv[]);
+
+/**
+ * Reads a whole file into a buffer allocated with new[]. Returns 0 and
+ * prints an error if the file cannot be read.
+ */
+byte *loadFile(const char *filename, uint32 &size);
+
+/** Prints a table header, followed by a line underlining its columns */
+void printTableHeader(const char *header);
+
+/**
+ * The linear congruential generator the benchmarks build their synthetic
+ * data with, so that every run works on the same data.
+ */
+class BenchmarkRandom {
+public:
+	BenchmarkRandom(uint32 seed) : _seed(seed) {}
+
+	/** Returns the next state. The low bits are not very random. */
+	uint32 next() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed;
+	}
+
+private:
+	uint32 _seed;
+};
+
+/** A piece of work to time */
+class BenchmarkLoop {
+public:
+	virtual ~BenchmarkLoop() {}
+
+	/** Does the work once */
+	virtual void run() = 0;
+
+	/** Repeats the work for at least minTime ms, returns the ms per run */
+	double measure(uint32 minTime = 500);
+
+	/** Does the work once, returns the ms it took, at least 1 */
+	uint32 measureOnce();
+};
+
+bool benchmarkBlending(int argc, char *argv[]);
+bool benchmarkDirtyRects(int argc, char *argv[]);
+bool benchmarkImages(int argc, char *argv[]);
+bool benchmarkOPL(int argc, char *argv[]);
+bool benchmarkADPCM(int argc, char *argv[]);
+bool benchmarkPaula(int argc, char *argv[]);
+bool benchmarkFMTowns(int argc, char *argv[]);
+#ifdef USE_SCALERS
+bool benchmarkScalers(int argc, char *argv[]);
+#endif
+
+#endif
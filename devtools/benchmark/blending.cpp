@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "graphics/transparent_surface.h"
+
+namespace {
+
+struct ModeDesc {
+	const char *name;
+	Graphics::AlphaType alphaMode;
+	Graphics::TSpriteBlendMode blendMode;
+	uint color;
+};
+
+const ModeDesc modes[] = {
+	{ "opaque", Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+	{ "binary", Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+	{ "alpha", Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+	{ "alpha+mod", Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0xC0A0C0E0 },
+	{ "additive", Graphics::ALPHA_FULL, Graphics::BLEND_ADDITIVE, 0xFFFFFFFF },
+	{ "additive+mod", Graphics::ALPHA_FULL, Graphics::BLEND_ADDITIVE, 0xC0A0C0E0 },
+	{ "subtractive", Graphics::ALPHA_FULL, Graphics::BLEND_SUBTRACTIVE, 0xFFFFFFFF },
+	{ "subtractive+mod", Graphics::ALPHA_FULL, Graphics::BLEND_SUBTRACTIVE, 0xC0A0C0E0 }
+};
+
+/** Blits a sprite to a different place of the screen on every run */
+class BlitLoop : public BenchmarkLoop {
+public:
+	BlitLoop(Graphics::TransparentSurface &sprite, Graphics::Surface &screen, const ModeDesc &mode) :
+		_sprite(sprite), _screen(screen), _mode(mode), _blits(0) {}
+
+	virtual void run() {
+		_sprite.blit(_screen, (_blits * 37) % (_screen.w - _sprite.w), (_blits * 23) % (_screen.h - _sprite.h),
+		             Graphics::FLIP_NONE, nullptr, _mode.color, -1, -1, _mode.blendMode);
+		++_blits;
+	}
+
+private:
+	Graphics::TransparentSurface &_sprite;
+	Graphics::Surface &_screen;
+	const ModeDesc &_mode;
+	uint32 _blits;
+};
+
+} // End of anonymous namespace
+
+/** Times every TransparentSurface blending mode, with the C and SIMD routines */
+bool benchmarkBlending(int argc, char *argv[]) {
+	if (argc)
+		return false;
+
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+	const int spriteSize = 256;
+
+	// A sprite with a soft edge around an opaque core, the usual case
+	Graphics::TransparentSurface sprite;
+	sprite.create(spriteSize, spriteSize, format);
+	BenchmarkRandom rng(0x12345678);
+	for (int y = 0; y < spriteSize; ++y) {
+		for (int x = 0; x < spriteSize; ++x) {
+			const uint32 noise = rng.next();
+			const int dist = MAX(ABS(x - spriteSize / 2), ABS(y - spriteSize / 2));
+			const uint32 alpha = (dist < spriteSize / 4) ? 255 : MAX(0, 255 - (dist - spriteSize / 4) * 8);
+			*(uint32 *)sprite.getBasePtr(x, y) = format.ARGBToColor(alpha, noise >> 8, noise >> 16, noise >> 24);
+		}
+	}
+
+	Graphics::Surface screen;
+	screen.create(640, 480, format);
+	screen.fillRect(Common::Rect(screen.w, screen.h), format.ARGBToColor(255, 64, 128, 192));
+
+	printTableHeader("Mode             C Mpixels/s  SIMD Mpixels/s");
+
+	for (int i = 0; i < ARRAYSIZE(modes); ++i) {
+		const ModeDesc &mode = modes[i];
+		sprite.setAlphaMode(mode.alphaMode);
+
+		double rate[2] = { 0.0, 0.0 };
+		for (int simd = 0; simd < 2; ++simd) {
+			if (simd && !Graphics::TransparentSurface::hasSIMDBlending())
+				break;
+			Graphics::TransparentSurface::setSIMDBlending(simd != 0);
+
+			BlitLoop loop(sprite, screen, mode);
+			rate[simd] = spriteSize * spriteSize / (loop.measure() * 1000.0);
+		}
+
+		if (Graphics::TransparentSurface::hasSIMDBlending())
+			printf("%-16s %11.1f %14.1f\n", mode.name, rate[0], rate[1]);
+		else
+			printf("%-16s %11.1f %14s\n", mode.name, rate[0], "n/a");
+	}
+
+	Graphics::TransparentSurface::setSIMDBlending(true);
+	sprite.free();
+	screen.free();
+	return true;
+}
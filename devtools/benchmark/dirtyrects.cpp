@@ -0,0 +1,158 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+#include "graphics/microtiles.h"
+
+namespace {
+
+const int16 screenW = 640, screenH = 480;
+
+/** A sprite moving around the screen */
+struct Sprite {
+	Common::Rect bounds;
+	int16 dx, dy;
+};
+
+/** Merges overlapping rectangles of a list, the way Graphics::Screen used to */
+void mergeOverlappingRects(Common::List<Common::Rect> &rects) {
+	for (Common::List<Common::Rect>::iterator rOuter = rects.begin(); rOuter != rects.end(); ++rOuter) {
+		Common::List<Common::Rect>::iterator rInner = rOuter;
+		while (++rInner != rects.end()) {
+			if ((*rOuter).intersects(*rInner)) {
+				(*rOuter).extend(*rInner);
+				rects.erase(rInner);
+				rInner = rOuter;
+			}
+		}
+	}
+}
+
+/** Moves sprites for a number of frames, collecting the dirty rects of each frame */
+class DirtyRectLoop : public BenchmarkLoop {
+public:
+	DirtyRectLoop(uint count, int frames, bool useTiles) :
+		_frames(frames), _useTiles(useTiles), _totalRects(0), _totalPixels(0.0) {
+		// Sprites of 16 to 96 pixels, moving a few pixels per frame
+		BenchmarkRandom rng(0x12345678);
+		for (uint i = 0; i < count; ++i) {
+			Sprite sprite;
+			uint32 seed = rng.next();
+			const int16 w = 16 + (seed >> 8) % 81, h = 16 + (seed >> 16) % 81;
+			seed = rng.next();
+			const int16 x = (seed >> 8) % (screenW - w), y = (seed >> 16) % (screenH - h);
+			sprite.bounds = Common::Rect(x, y, x + w, y + h);
+			sprite.dx = (int16)((seed >> 4) % 9) - 4;
+			sprite.dy = (int16)((seed >> 12) % 9) - 4;
+			_sprites.push_back(sprite);
+		}
+	}
+
+	virtual void run() {
+		Graphics::MicroTileArray tiles(screenW, screenH);
+		Common::Array<Common::Rect> tileRects;
+		Common::List<Common::Rect> listRects;
+
+		for (int frame = 0; frame < _frames; ++frame) {
+			for (uint i = 0; i < _sprites.size(); ++i) {
+				Sprite &sprite = _sprites[i];
+				const Common::Rect oldBounds = sprite.bounds;
+				if (sprite.bounds.left + sprite.dx < 0 || sprite.bounds.right + sprite.dx > screenW)
+					sprite.dx = -sprite.dx;
+				if (sprite.bounds.top + sprite.dy < 0 || sprite.bounds.bottom + sprite.dy > screenH)
+					sprite.dy = -sprite.dy;
+				sprite.bounds.translate(sprite.dx, sprite.dy);
+
+				if (_useTiles) {
+					tiles.addRect(oldBounds);
+					tiles.addRect(sprite.bounds);
+				} else {
+					listRects.push_back(oldBounds);
+					listRects.push_back(sprite.bounds);
+				}
+			}
+
+			if (_useTiles) {
+				tileRects.resize(0);
+				tiles.getRectangles(tileRects);
+				tiles.clear();
+				_totalRects += tileRects.size();
+				for (uint i = 0; i < tileRects.size(); ++i)
+					_totalPixels += tileRects[i].width() * tileRects[i].height();
+			} else {
+				mergeOverlappingRects(listRects);
+				_totalRects += listRects.size();
+				for (Common::List<Common::Rect>::const_iterator r = listRects.begin(); r != listRects.end(); ++r)
+					_totalPixels += r->width() * r->height();
+				listRects.clear();
+			}
+		}
+	}
+
+	uint getRectsPerFrame() const { return _totalRects / _frames; }
+	uint getPixelsPerFrame() const { return (uint)(_totalPixels / _frames); }
+
+private:
+	Common::Array<Sprite> _sprites;
+	int _frames;
+	bool _useTiles;
+	uint _totalRects;
+	double _totalPixels;
+};
+
+} // End of anonymous namespace
+
+/** Times the dirty rectangle tracking with moving sprites, against a merged list */
+bool benchmarkDirtyRects(int argc, char *argv[]) {
+	if (argc)
+		return false;
+
+	const int frames = 20000;
+	static const uint spriteCounts[] = { 4, 16, 64, 256 };
+
+	printTableHeader("Sprites  Tiles frames/s  Rects  Pixels   List frames/s  Rects  Pixels");
+
+	for (int i = 0; i < ARRAYSIZE(spriteCounts); ++i) {
+		const uint count = spriteCounts[i];
+		double rate[2];
+		uint rects[2], pixels[2];
+
+		for (int method = 0; method < 2; ++method) {
+			DirtyRectLoop loop(count, frames, method == 0);
+			rate[method] = frames * 1000.0 / loop.measureOnce();
+			rects[method] = loop.getRectsPerFrame();
+			pixels[method] = loop.getPixelsPerFrame();
+		}
+
+		printf("%7u  %14.0f  %5u  %7u  %13.0f  %5u  %7u\n", count,
+		       rate[0], rects[0], pixels[0], rate[1], rects[1], pixels[1]);
+	}
+
+	return true;
+}
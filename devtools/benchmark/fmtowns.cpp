@@ -0,0 +1,245 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "audio/mixer_intern.h"
+#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth.h"
+
+#include <stdlib.h>
+
+namespace {
+
+const int rate = 44100;
+
+/** A register write in a captured FM-Towns/PC-98 register stream */
+struct FMWrite {
+	uint32 tick;
+	uint8 part;
+	uint8 reg;
+	uint8 value;
+};
+
+/**
+ * Creates a register stream for six fm channels and the ssg, as a sound
+ * driver would write it from its timer. Each channel plays notes of
+ * varying length with a new instrument every few notes, so that all
+ * algorithms, feedback levels and envelope phases get used.
+ */
+Common::Array<FMWrite> createFMStream(uint32 ticks) {
+	Common::Array<FMWrite> writes;
+	BenchmarkRandom rng(0x2468ace);
+	uint32 nextEvent[6] = { 0, 0, 0, 0, 0, 0 };
+	bool keyOn[6] = { false, false, false, false, false, false };
+
+	for (uint32 tick = 0; tick < ticks; ++tick) {
+		for (int ch = 0; ch < 6; ++ch) {
+			if (tick < nextEvent[ch])
+				continue;
+
+			const uint8 part = ch / 3, c = ch % 3;
+			const uint8 keyChan = c | (part ? 4 : 0);
+			uint32 rnd = rng.next() >> 8;
+
+			if (keyOn[ch]) {
+				FMWrite w = { tick, 0, 0x28, keyChan };
+				writes.push_back(w);
+				keyOn[ch] = false;
+				nextEvent[ch] = tick + 4 + rnd % 40;
+				continue;
+			}
+
+			if (!(rnd & 3)) {
+				FMWrite w = { tick, part, (uint8)(0xb0 + c), (uint8)((rnd >> 2) & 0x3f) };
+				writes.push_back(w);
+				w.reg = 0xb4 + c;
+				w.value = 0xc0;
+				writes.push_back(w);
+				for (int op = 0; op < 4; ++op) {
+					rnd = rng.next() >> 8;
+					static const uint8 regs[] = { 0x30, 0x40, 0x50, 0x60, 0x70, 0x80 };
+					const uint8 values[] = {
+						(uint8)(rnd & 0x7f), (uint8)(((rnd >> 7) & 0x1f) + (op == 3 ? 0 : 0x10)),
+						(uint8)(((rnd >> 12) & 0xdf) | 0x10), (uint8)((rnd >> 4) & 0x1f),
+						(uint8)((rnd >> 9) & 0x1f), (uint8)((rnd >> 14) | 0x04)
+					};
+					for (int r = 0; r < ARRAYSIZE(regs); ++r) {
+						w.reg = regs[r] + c + op * 4;
+						w.value = values[r];
+						writes.push_back(w);
+					}
+				}
+			}
+
+			rnd = rng.next() >> 8;
+			const uint16 frq = ((2 + rnd % 5) << 11) | (0x200 + (rnd >> 4) % 0x200);
+			FMWrite w = { tick, part, (uint8)(0xa4 + c), (uint8)(frq >> 8) };
+			writes.push_back(w);
+			w.reg = 0xa0 + c;
+			w.value = frq & 0xff;
+			writes.push_back(w);
+			w.part = 0;
+			w.reg = 0x28;
+			w.value = keyChan | 0xf0;
+			writes.push_back(w);
+			keyOn[ch] = true;
+			nextEvent[ch] = tick + 8 + (rnd >> 12) % 120;
+		}
+
+		// Square waves and noise on the ssg of the PC-98 sound boards
+		if (!(tick % 32)) {
+			const uint32 rnd = rng.next() >> 8;
+			for (int c = 0; c < 3; ++c) {
+				FMWrite w = { tick, 0, (uint8)(c * 2), (uint8)(rnd >> (c * 4)) };
+				writes.push_back(w);
+				w.reg = c * 2 + 1;
+				w.value = (rnd >> (c * 3)) & 3;
+				writes.push_back(w);
+				w.reg = 8 + c;
+				w.value = ((rnd >> 20) & 1) ? 0x0c : 0;
+				writes.push_back(w);
+			}
+			FMWrite w = { tick, 0, 0x07, (uint8)(0x38 ^ ((rnd >> 21) & 0x3f)) };
+			writes.push_back(w);
+		}
+	}
+
+	return writes;
+}
+
+/** Replays a register stream from timer A, like the engines' sound drivers */
+class FMSynth : public TownsPC98_FmSynth {
+public:
+	FMSynth(Audio::Mixer *mixer, EmuType type, const Common::Array<FMWrite> &writes) :
+		TownsPC98_FmSynth(mixer, type, true), _writes(writes), _next(0), _tick(0) {}
+
+	void start() {
+		init();
+		reset();
+		// 200 timer ticks per second
+		const uint16 timerA = 0x400 - 276;
+		writeReg(0, 0x24, timerA >> 2);
+		writeReg(0, 0x25, timerA & 3);
+		writeReg(0, 0x27, 0x15);
+	}
+
+protected:
+	virtual void timerCallbackA() {
+		while (_next < _writes.size() && _writes[_next].tick <= _tick) {
+			writeReg(_writes[_next].part, _writes[_next].reg, _writes[_next].value);
+			++_next;
+		}
+		++_tick;
+	}
+
+	virtual void timerCallbackB() {}
+
+private:
+	const Common::Array<FMWrite> &_writes;
+	uint _next;
+	uint32 _tick;
+};
+
+/** Reads a number of frames from a synth in buffers of the given size, checksumming the output */
+class RenderLoop : public BenchmarkLoop {
+public:
+	RenderLoop(FMSynth &synth, uint32 frames, int bufferFrames) :
+		_synth(synth), _frames(frames), _bufferFrames(bufferFrames), _checksum(0) {}
+
+	virtual void run() {
+		int16 *buffer = new int16[_bufferFrames * 2];
+		for (uint32 pos = 0; pos < _frames; pos += _bufferFrames) {
+			const int count = MIN<uint32>(_bufferFrames, _frames - pos) * 2;
+			_synth.readBuffer(buffer, count);
+			for (int i = 0; i < count; ++i)
+				_checksum = _checksum * 31 + (uint16)buffer[i];
+		}
+		delete[] buffer;
+	}
+
+	uint32 getChecksum() const { return _checksum; }
+
+private:
+	FMSynth &_synth;
+	uint32 _frames;
+	int _bufferFrames;
+	uint32 _checksum;
+};
+
+} // End of anonymous namespace
+
+/**
+ * Times the FM-Towns and PC-98 sound chip emulation replaying a register
+ * stream, read in buffers of the given number of frames or in a range of
+ * buffer sizes if none is given. The checksum doesn't depend on the buffer
+ * size, since the register writes happen on the emulated timer.
+ */
+bool benchmarkFMTowns(int argc, char *argv[]) {
+	if (argc > 1)
+		return false;
+
+	static const struct {
+		const char *name;
+		TownsPC98_FmSynth::EmuType type;
+	} chips[] = {
+		{ "FM-Towns", TownsPC98_FmSynth::kTypeTowns },
+		{ "PC-98/86", TownsPC98_FmSynth::kType86 }
+	};
+	static const int defaultFrames[] = { 16, 64, 256, 1024, 4096 };
+	const uint32 seconds = 120;
+
+	const int frames = argc ? atoi(argv[0]) : 0;
+	if (argc && frames <= 0)
+		return false;
+
+	const int numSizes = frames ? 1 : ARRAYSIZE(defaultFrames);
+	const int *sizes = frames ? &frames : defaultFrames;
+
+	// The synth plays itself through a mixer
+	Audio::MixerImpl *mixer = new Audio::MixerImpl(g_system, rate);
+	mixer->setReady(true);
+
+	const Common::Array<FMWrite> writes = createFMStream(seconds * 200);
+	printf("%u register writes, %u s of music\n\n", writes.size(), seconds);
+	printTableHeader("Chip      Frames    ms  x realtime  Checksum");
+
+	for (int c = 0; c < ARRAYSIZE(chips); ++c) {
+		for (int s = 0; s < numSizes; ++s) {
+			FMSynth *synth = new FMSynth(mixer, chips[c].type, writes);
+			synth->start();
+
+			RenderLoop loop(*synth, seconds * rate, sizes[s]);
+			const uint32 elapsed = loop.measureOnce();
+			delete synth;
+
+			printf("%-8s  %6d  %4u  %10.1f  %08x\n", chips[c].name, sizes[s], elapsed,
+			       seconds * 1000.0 / elapsed, loop.getChecksum());
+		}
+	}
+
+	delete mixer;
+	return true;
+}
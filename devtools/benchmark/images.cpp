@@ -0,0 +1,171 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "graphics/surface.h"
+#include "image/jpeg.h"
+#include "image/png.h"
+
+namespace {
+
+/** An image file loaded in memory */
+struct ImageFile {
+	byte *data;
+	uint32 size;
+	bool isPNG;
+};
+
+/** Decodes all images to the given format, either directly or with a conversion pass */
+class DecodeLoop : public BenchmarkLoop {
+public:
+	DecodeLoop(const Common::Array<ImageFile> &images, const Graphics::PixelFormat &format, bool direct) :
+		_images(images), _format(format), _direct(direct) {}
+
+	virtual void run() {
+		for (uint i = 0; i < _images.size(); ++i)
+			decode(_images[i]);
+	}
+
+private:
+	void decode(const ImageFile &image) {
+		Common::MemoryReadStream stream(image.data, image.size);
+
+		if (image.isPNG) {
+#ifdef USE_PNG
+			Image::PNGDecoder decoder;
+			if (_direct)
+				decoder.setOutputPixelFormat(_format);
+			decoder.loadStream(stream);
+			if (!_direct && decoder.getSurface()->format.bytesPerPixel != 1)
+				convert(decoder.getSurface());
+#endif
+		} else {
+#ifdef USE_JPEG
+			Image::JPEGDecoder decoder;
+			if (_direct)
+				decoder.setOutputPixelFormat(_format);
+			decoder.loadStream(stream);
+			if (!_direct)
+				convert(decoder.getSurface());
+#endif
+		}
+	}
+
+	void convert(const Graphics::Surface *surface) {
+		Graphics::Surface *converted = surface->convertTo(_format);
+		converted->free();
+		delete converted;
+	}
+
+	const Common::Array<ImageFile> &_images;
+	const Graphics::PixelFormat &_format;
+	bool _direct;
+};
+
+} // End of anonymous namespace
+
+/** Times the PNG and JPEG decoders on a set of images, with and without direct output */
+bool benchmarkImages(int argc, char *argv[]) {
+	if (!argc)
+		return false;
+
+	static const Graphics::PixelFormat formats[] = {
+		Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+		Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+		Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+	};
+	static const char *const formatNames[] = { "RGB565", "ARGB8888", "RGBA8888" };
+
+	// Load the images in memory, so that only decoding is timed
+	Common::Array<ImageFile> images[2];
+	uint32 bytes[2] = { 0, 0 };
+	for (int i = 0; i < argc; ++i) {
+		Common::String name = argv[i];
+		name.toLowercase();
+		const bool isPNG = name.hasSuffix(".png");
+		if (!isPNG && !name.hasSuffix(".jpg") && !name.hasSuffix(".jpeg"))
+			continue;
+
+		ImageFile image;
+		image.data = loadFile(argv[i], image.size);
+		image.isPNG = isPNG;
+		if (!image.data)
+			continue;
+
+		// Skip files which are not what their name says
+		bool valid = isPNG ? (image.size >= 8 && READ_BE_UINT32(image.data) == MKTAG(0x89, 'P', 'N', 'G'))
+		                   : (image.size >= 2 && READ_BE_UINT16(image.data) == 0xFFD8);
+#ifndef USE_PNG
+		if (isPNG)
+			valid = false;
+#endif
+#ifndef USE_JPEG
+		if (!isPNG)
+			valid = false;
+#endif
+		if (!valid) {
+			delete[] image.data;
+			continue;
+		}
+
+		images[isPNG ? 0 : 1].push_back(image);
+		bytes[isPNG ? 0 : 1] += image.size;
+	}
+
+	if (images[0].empty() && images[1].empty()) {
+		printf("No PNG or JPEG images to decode\n");
+		return true;
+	}
+
+	printTableHeader("Codec  Images  KBytes  Format    Converted ms  Direct ms  Speedup");
+
+	for (int codec = 0; codec < 2; ++codec) {
+		if (images[codec].empty())
+			continue;
+
+		for (int f = 0; f < ARRAYSIZE(formats); ++f) {
+			double time[2];
+			for (int direct = 0; direct < 2; ++direct) {
+				DecodeLoop loop(images[codec], formats[f], direct != 0);
+				time[direct] = loop.measure();
+			}
+
+			printf("%-5s  %6u  %6u  %-8s  %12.1f  %9.1f  %6.2fx\n", codec == 0 ? "PNG" : "JPEG",
+			       images[codec].size(), bytes[codec] / 1024, formatNames[f], time[0], time[1], time[0] / time[1]);
+		}
+	}
+
+	for (int codec = 0; codec < 2; ++codec) {
+		for (uint i = 0; i < images[codec].size(); ++i)
+			delete[] images[codec][i].data;
+	}
+
+	return true;
+}
@@ -0,0 +1,37 @@
+
+MODULE := devtools/benchmark
+
+MODULE_OBJS := \
+	adpcm.o \
+	benchmark.o \
+	blending.o \
+	dirtyrects.o \
+	fmtowns.o \
+	images.o \
+	opl.o \
+	paula.o \
+	scalers.o
+
+BENCHMARK_LIBS := \
+	image/libimage.a \
+	graphics/libgraphics.a \
+	audio/libaudio.a \
+	common/libcommon.a
+
+# Not built with rules.mk: the benchmarks link against ScummVM's own
+# libraries and the system libraries these depend on
+TOOL-$(MODULE) := $(MODULE)/benchmark$(EXEEXT)
+MODULE_OBJS-$(MODULE) := $(addprefix $(MODULE)/, $(MODULE_OBJS))
+MODULE_DIRS += $(MODULE)/
+
+$(TOOL-$(MODULE)): $(MODULE_OBJS-$(MODULE)) $(BENCHMARK_LIBS)
+	$(QUIET_LINK)$(LD) $(LDFLAGS) $+ $(LIBS) -o $@
+
+devtools: $(TOOL-$(MODULE))
+$(MODULE): $(TOOL-$(MODULE))
+
+clean-devtools: clean-$(MODULE)
+clean-$(MODULE):
+	-$(RM) $(MODULE_OBJS-$(MODULE)) $(TOOL-$(MODULE))
+
+.PHONY: clean-$(MODULE) $(MODULE)
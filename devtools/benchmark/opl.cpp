@@ -0,0 +1,238 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "audio/softsynth/opl/dbopl.h"
+#include "audio/softsynth/opl/mame.h"
+
+namespace {
+
+const uint rate = 44100;
+
+/** A register write from a DOSBox raw OPL capture */
+struct OPLWrite {
+	uint32 time;
+	uint16 reg;
+	uint8 value;
+};
+
+/** Loads a version 2 DOSBox raw OPL capture, returning its hardware type or -1 */
+int loadDROCapture(const char *filename, Common::Array<OPLWrite> &writes) {
+	uint32 size;
+	byte *data = loadFile(filename, size);
+	if (!data)
+		return -1;
+
+	Common::MemoryReadStream stream(data, size, DisposeAfterUse::YES);
+
+	byte header[26];
+	if (stream.read(header, sizeof(header)) != sizeof(header) || memcmp(header, "DBRAWOPL", 8) ||
+	    READ_LE_UINT16(header + 8) != 2 || header[21] != 0 || header[22] != 0)
+		return -1;
+
+	const uint32 pairs = READ_LE_UINT32(header + 12);
+	const int hardwareType = header[20];
+	const byte shortDelay = header[23], longDelay = header[24];
+	byte codemap[128];
+	if (header[25] > sizeof(codemap) || stream.read(codemap, header[25]) != header[25])
+		return -1;
+
+	uint32 time = 0;
+	for (uint32 i = 0; i < pairs && !stream.eos(); ++i) {
+		const byte index = stream.readByte();
+		const byte value = stream.readByte();
+
+		if (index == shortDelay) {
+			time += value + 1;
+		} else if (index == longDelay) {
+			time += (value + 1) << 8;
+		} else if ((index & 0x7F) < header[25]) {
+			OPLWrite write;
+			write.time = time;
+			write.reg = codemap[index & 0x7F] | ((index & 0x80) ? 0x100 : 0);
+			write.value = value;
+			writes.push_back(write);
+		}
+	}
+
+	return hardwareType;
+}
+
+/** Drives one of the OPL emulators directly, as its OPL::EmulatedOPL would */
+class OPLChip {
+public:
+	OPLChip(bool mame, bool dual) : _mame(0) {
+#ifndef DISABLE_DOSBOX_OPL
+		_dosbox = 0;
+#endif
+		if (mame) {
+			_mame = OPL::MAME::makeAdLibOPL(rate);
+		} else {
+#ifndef DISABLE_DOSBOX_OPL
+			OPL::DOSBox::DBOPL::InitTables();
+			_dosbox = new OPL::DOSBox::DBOPL::Chip();
+			_dosbox->Setup(rate);
+			if (dual)
+				_dosbox->WriteReg(0x105, 1);
+#endif
+		}
+	}
+
+	~OPLChip() {
+		if (_mame)
+			OPL::MAME::OPLDestroy(_mame);
+#ifndef DISABLE_DOSBOX_OPL
+		delete _dosbox;
+#endif
+	}
+
+	void write(uint reg, uint8 value) {
+		if (_mame)
+			OPL::MAME::OPLWriteReg(_mame, reg, value);
+#ifndef DISABLE_DOSBOX_OPL
+		else
+			_dosbox->WriteReg(reg, value);
+#endif
+	}
+
+	void generate(int16 *buffer, uint frames) {
+		if (_mame) {
+			OPL::MAME::YM3812UpdateOne(_mame, buffer, frames);
+			return;
+		}
+
+#ifndef DISABLE_DOSBOX_OPL
+		int32 temp[512 * 2];
+		const uint channels = _dosbox->opl3Active ? 2 : 1;
+		while (frames > 0) {
+			const uint step = MIN<uint>(frames, 512);
+			if (channels == 2)
+				_dosbox->GenerateBlock3(step, temp);
+			else
+				_dosbox->GenerateBlock2(step, temp);
+			for (uint i = 0; i < step * channels; ++i)
+				buffer[i] = temp[i];
+			buffer += step * channels;
+			frames -= step;
+		}
+#endif
+	}
+
+private:
+	OPL::MAME::FM_OPL *_mame;
+#ifndef DISABLE_DOSBOX_OPL
+	OPL::DOSBox::DBOPL::Chip *_dosbox;
+#endif
+};
+
+/**
+ * Renders a capture in mixer sized buffers. When perTick is set, each
+ * buffer is split at every tick of a 1 kHz callback, as readBuffer() used
+ * to do, otherwise only where register writes fall.
+ */
+class RenderLoop : public BenchmarkLoop {
+public:
+	RenderLoop(const Common::Array<OPLWrite> &writes, bool mame, bool dual, bool perTick, uint32 length) :
+		_writes(writes), _mame(mame), _dual(dual), _perTick(perTick), _length(length) {}
+
+	virtual void run() {
+		const uint bufferFrames = 2048;
+		int16 *buffer = new int16[bufferFrames * 2];
+		OPLChip chip(_mame, _dual);
+
+		uint next = 0;
+		uint32 pos = 0;
+		while (pos < _length) {
+			const uint32 end = MIN<uint32>(pos + bufferFrames, _length);
+			while (pos < end) {
+				while (next < _writes.size() && (uint64)_writes[next].time * rate / 1000 <= pos) {
+					chip.write(_writes[next].reg, _writes[next].value);
+					++next;
+				}
+
+				uint32 step = end;
+				if (_perTick)
+					step = MIN<uint32>(step, (((uint64)pos * 1000 / rate + 1) * rate + 999) / 1000);
+				else if (next < _writes.size())
+					step = MIN<uint32>(step, (uint64)_writes[next].time * rate / 1000);
+
+				chip.generate(buffer, step - pos);
+				pos = step;
+			}
+		}
+
+		delete[] buffer;
+	}
+
+private:
+	const Common::Array<OPLWrite> &_writes;
+	bool _mame, _dual, _perTick;
+	uint32 _length;
+};
+
+} // End of anonymous namespace
+
+/** Times the OPL emulators rendering a DOSBox capture, split per tick and per write */
+bool benchmarkOPL(int argc, char *argv[]) {
+	if (argc != 1)
+		return false;
+
+	Common::Array<OPLWrite> writes;
+	const int hardwareType = loadDROCapture(argv[0], writes);
+	if (hardwareType < 0 || writes.empty()) {
+		printf("'%s' is not a version 2 DOSBox raw OPL capture\n", argv[0]);
+		return true;
+	}
+
+	const uint32 length = (uint64)(writes.back().time + 1000) * rate / 1000;
+	printf("%u register writes, %.1f s of music (%s)\n\n", writes.size(), (double)length / rate,
+	       hardwareType == 0 ? "OPL2" : (hardwareType == 1 ? "dual OPL2" : "OPL3"));
+	printTableHeader("Emulator  Per tick ms  Per write ms  Speedup  Realtime");
+
+	for (int mame = 0; mame < 2; ++mame) {
+#ifdef DISABLE_DOSBOX_OPL
+		if (!mame)
+			continue;
+#endif
+		// The MAME emulator is a plain OPL2
+		if (mame && hardwareType != 0)
+			continue;
+
+		double time[2];
+		for (int perTick = 1; perTick >= 0; --perTick) {
+			RenderLoop loop(writes, mame != 0, hardwareType == 1, perTick != 0, length);
+			time[perTick] = loop.measureOnce();
+		}
+
+		printf("%-8s  %11.0f  %12.0f  %6.2fx  %7.0fx\n", mame ? "MAME" : "DOSBox",
+		       time[1], time[0], time[1] / time[0], length * 1000.0 / rate / time[0]);
+	}
+
+	return true;
+}
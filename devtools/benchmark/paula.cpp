@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "audio/mods/paula.h"
+#include "audio/mods/protracker.h"
+
+#include <math.h>
+
+namespace {
+
+/**
+ * Creates a ProTracker module with four looped waveforms, played as
+ * arpeggios over the whole note range on all channels.
+ */
+Common::Array<byte> createModule() {
+	static const int16 periods[] = {
+		856, 808, 762, 720, 678, 640, 604, 570, 538, 508, 480, 453,
+		428, 404, 381, 360, 339, 320, 302, 285, 269, 254, 240, 226,
+		214, 202, 190, 180, 170, 160, 151, 143, 135, 127, 120, 113
+	};
+	const int numPatterns = 4;
+	const int sampleLength = 512;
+
+	Common::Array<byte> data;
+	data.resize(1084 + numPatterns * 1024 + 4 * sampleLength);
+	memset(data.begin(), 0, data.size());
+	byte *header = data.begin() + 20;
+	for (int i = 0; i < 4; ++i, header += 30) {
+		WRITE_BE_UINT16(header + 22, sampleLength / 2);
+		header[25] = 64;
+		WRITE_BE_UINT16(header + 26, 0);
+		WRITE_BE_UINT16(header + 28, sampleLength / 2);
+	}
+
+	data[950] = numPatterns;
+	data[951] = 127;
+	for (int i = 0; i < numPatterns; ++i)
+		data[952 + i] = i;
+	WRITE_BE_UINT32(data.begin() + 1080, MKTAG('M', '.', 'K', '.'));
+
+	byte *note = data.begin() + 1084;
+	for (int pattern = 0; pattern < numPatterns; ++pattern) {
+		for (int row = 0; row < 64; ++row) {
+			for (int channel = 0; channel < 4; ++channel, note += 4) {
+				const int sample = 1 + (channel + pattern) % 4;
+				const int16 period = periods[(row * 7 + channel * 5 + pattern * 3) % ARRAYSIZE(periods)];
+				WRITE_BE_UINT32(note, (uint32)(sample & 0x10) << 24 | (uint32)period << 16 | (sample & 0x0F) << 12);
+			}
+		}
+	}
+
+	// Sine, square, saw and noise
+	int8 *sample = (int8 *)note;
+	BenchmarkRandom rng(0x12345678);
+	for (int i = 0; i < sampleLength; ++i) {
+		const int phase = i % 64;
+		sample[i] = (int8)(127 * sin(2 * M_PI * phase / 64));
+		sample[sampleLength + i] = (phase < 32) ? 100 : -100;
+		sample[2 * sampleLength + i] = (int8)(phase * 4 - 128);
+		sample[3 * sampleLength + i] = (int8)(rng.next() >> 24);
+	}
+
+	return data;
+}
+
+/** Plays a module for a number of samples */
+class PlayLoop : public BenchmarkLoop {
+public:
+	PlayLoop(Audio::AudioStream *stream, uint32 samples) : _stream(stream), _samples(samples) {}
+
+	virtual void run() {
+		const int bufferSamples = 2048;
+		int16 buffer[bufferSamples];
+		for (uint32 samples = 0; samples < _samples; samples += bufferSamples)
+			_stream->readBuffer(buffer, bufferSamples);
+	}
+
+private:
+	Audio::AudioStream *_stream;
+	uint32 _samples;
+};
+
+} // End of anonymous namespace
+
+/** Times the Paula emulation playing a synthetic module, with and without band-limited mixing */
+bool benchmarkPaula(int argc, char *argv[]) {
+	if (argc)
+		return false;
+
+	static const struct {
+		const char *name;
+		bool stereo;
+		bool bandLimited;
+	} modes[] = {
+		{ "Mono", false, false },
+		{ "Stereo", true, false },
+		{ "Mono, band-limited", false, true },
+		{ "Stereo, band-limited", true, true }
+	};
+	const int rate = 44100;
+	const uint32 seconds = 600;
+
+	Common::Array<byte> module = createModule();
+
+	printTableHeader("Mode                    ms  x realtime");
+
+	for (int m = 0; m < ARRAYSIZE(modes); ++m) {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(module.begin(), module.size());
+		Audio::AudioStream *audio = Audio::makeProtrackerStream(stream, 0, rate, modes[m].stereo);
+		delete stream;
+
+		// ProTracker modules are always played by a Paula
+		static_cast<Audio::Paula *>(audio)->setBandLimited(modes[m].bandLimited);
+
+		PlayLoop loop(audio, seconds * rate * (modes[m].stereo ? 2 : 1));
+		const uint32 elapsed = loop.measureOnce();
+		delete audio;
+
+		printf("%-20s  %4u  %10.1f\n", modes[m].name, elapsed, seconds * 1000.0 / elapsed);
+	}
+
+	return true;
+}
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use printf.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "devtools/benchmark/benchmark.h"
+
+#ifdef USE_SCALERS
+
+#include "graphics/scaler.h"
+
+namespace {
+
+struct ScalerDesc {
+	const char *name;
+	ScalerProc *proc;
+	int factor;
+};
+
+const ScalerDesc scalers[] = {
+	{ "1x", Normal1x, 1 },
+	{ "2x", Normal2x, 2 },
+	{ "3x", Normal3x, 3 },
+	{ "2xsai", _2xSaI, 2 },
+	{ "super2xsai", Super2xSaI, 2 },
+	{ "supereagle", SuperEagle, 2 },
+	{ "advmame2x", AdvMame2x, 2 },
+	{ "advmame3x", AdvMame3x, 3 },
+#ifdef USE_HQ_SCALERS
+	{ "hq2x", HQ2x, 2 },
+	{ "hq3x", HQ3x, 3 },
+#endif
+	{ "tv2x", TV2x, 2 },
+	{ "dotmatrix", DotMatrix, 2 }
+};
+
+/** Scales a whole frame with one scaler */
+class ScalerLoop : public BenchmarkLoop {
+public:
+	ScalerLoop(const ScalerDesc &scaler, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height) :
+		_scaler(scaler), _src(src), _srcPitch(srcPitch), _dst(dst), _dstPitch(dstPitch), _width(width), _height(height) {}
+
+	virtual void run() {
+		_scaler.proc(_src, _srcPitch, _dst, _dstPitch, _width, _height);
+	}
+
+private:
+	const ScalerDesc &_scaler;
+	const byte *_src;
+	uint32 _srcPitch;
+	byte *_dst;
+	uint32 _dstPitch;
+	int _width, _height;
+};
+
+} // End of anonymous namespace
+
+/** Times every scaler, for all pixel sizes, on synthetic frames */
+bool benchmarkScalers(int argc, char *argv[]) {
+	if (argc)
+		return false;
+
+	static const int bitFormats[] = { 565, 8888 };
+
+	// 640x360 scaled 3x gives a 1080p frame
+	static const int frameSizes[][2] = { { 320, 200 }, { 640, 480 }, { 640, 360 } };
+
+	// The scalers access up to two pixels around the area they scale
+	const int border = 2;
+	const int maxWidth = 640 + 2 * border;
+	const int maxHeight = 480 + 2 * border;
+
+	byte *src = new byte[maxWidth * maxHeight * 4];
+	byte *dst = new byte[maxWidth * 3 * maxHeight * 3 * 4];
+
+	printTableHeader("Scaler        Bpp  Source    Output     ms/frame  Mpixels/s");
+
+	for (int f = 0; f < ARRAYSIZE(bitFormats); ++f) {
+		InitScalers(bitFormats[f]);
+		const int bytesPerPixel = (bitFormats[f] == 8888) ? 4 : 2;
+
+		for (int s = 0; s < ARRAYSIZE(frameSizes); ++s) {
+			const int width = frameSizes[s][0];
+			const int height = frameSizes[s][1];
+			const uint32 srcPitch = (width + 2 * border) * bytesPerPixel;
+
+			// Fill the frame with large flat areas, mixed with noisy
+			// ones, so that both the fast and slow paths of the scalers
+			// are taken
+			BenchmarkRandom rng(0x12345678);
+			for (int y = 0; y < height + 2 * border; ++y) {
+				for (int x = 0; x < width + 2 * border; ++x) {
+					const uint32 noise = rng.next() >> 8;
+					uint32 color = ((x / 16 + y / 16) & 1) ? noise : ((x / 32) * 0x10101 + (y / 32) * 0x20202);
+					byte *pixel = src + y * srcPitch + x * bytesPerPixel;
+					if (bytesPerPixel == 2)
+						*(uint16 *)pixel = (uint16)color;
+					else
+						*(uint32 *)pixel = color | 0xFF000000;
+				}
+			}
+
+			for (int i = 0; i < ARRAYSIZE(scalers); ++i) {
+				const ScalerDesc &scaler = scalers[i];
+				ScalerLoop loop(scaler, src + border * srcPitch + border * bytesPerPixel, srcPitch,
+				                dst, width * scaler.factor * bytesPerPixel, width, height);
+
+				const double msPerFrame = loop.measure();
+				const double outputPixels = (double)width * scaler.factor * height * scaler.factor;
+				printf("%-12s  %3d  %3dx%-4d  %4dx%-4d  %8.3f  %9.1f\n", scaler.name, bytesPerPixel * 8,
+				       width, height, width * scaler.factor, height * scaler.factor,
+				       msPerFrame, outputPixels / (msPerFrame * 1000.0));
+			}
+		}
+	}
+
+	DestroyScalers();
+	delete[] src;
+	delete[] dst;
+	return true;
+}
+
+#endif
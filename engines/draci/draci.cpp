@@ -363,6 +363,9 @@ void DraciEngine::handleEvents() {
 		}
 	}
 
+	// Write the music being recorded to the music cache
+	_music->updateMusicCache();
+
 	// Handle EVENT_QUIT and EVENT_RTL.
 	if (shouldQuit()) {
 		_game->setQuit(true);
@@ -65,8 +65,8 @@ void MusicPlayer::sendToChannel(byte channel, uint32 b) {
 }
 
 void MusicPlayer::playSMF(int track, bool loop) {
-	Common::StackLock lock(_mutex);
-
+	// stop() and playCachedMusic() call the mixer, so they must be called
+	// without holding _mutex, see Audio::MidiPlayer::onTimer()
 	if (_isPlaying && track == _track) {
 		debugC(2, kDraciSoundDebugLevel, "Already plaing track %d", track);
 		return;
@@ -90,6 +90,16 @@ void MusicPlayer::playSMF(int track, bool loop) {
 	musicFile.read(_midiData, midiMusicSize);
 	musicFile.close();
 
+	syncVolume();
+
+	if (playCachedMusic(_midiData, midiMusicSize, loop)) {
+		_track = track;
+		debugC(2, kDraciSoundDebugLevel, "Playing track %d from the music cache", track);
+		return;
+	}
+
+	Common::StackLock lock(_mutex);
+
 	MidiParser *parser = MidiParser::createParser_SMF();
 	if (parser->loadMusic(_midiData, midiMusicSize)) {
 		parser->setTrack(0);
@@ -38,7 +38,7 @@ Screen::Screen(NeverhoodEngine *vm)
 
 	_renderQueue = new RenderQueue();
 	_prevRenderQueue = new RenderQueue();
-	_microTiles = new MicroTileArray(640, 480);
+	_microTiles = new Graphics::MicroTileArray(640, 480);
 
 }
 
@@ -88,24 +88,23 @@ void Screen::update() {
 		renderItem._refresh = true;
 	}
 
-	RectangleList *updateRects = _microTiles->getRectangles();
+	Common::List<Common::Rect> updateRects;
+	_microTiles->getRectangles(updateRects);
 
 	for (RenderQueue::iterator it = _renderQueue->begin(); it != _renderQueue->end(); ++it) {
 		RenderItem &renderItem = (*it);
-		for (RectangleList::iterator ri = updateRects->begin(); ri != updateRects->end(); ++ri)
+		for (Common::List<Common::Rect>::iterator ri = updateRects.begin(); ri != updateRects.end(); ++ri)
 			blitRenderItem(renderItem, *ri);
 	}
 
 	SWAP(_renderQueue, _prevRenderQueue);
 	_renderQueue->clear();
 
-	for (RectangleList::iterator ri = updateRects->begin(); ri != updateRects->end(); ++ri) {
+	for (Common::List<Common::Rect>::iterator ri = updateRects.begin(); ri != updateRects.end(); ++ri) {
 		Common::Rect &r = *ri;
 		_vm->_system->copyRectToScreen((const byte*)_backScreen->getBasePtr(r.left, r.top), _backScreen->pitch, r.left, r.top, r.width(), r.height());
 	}
 
-	delete updateRects;
-
 }
 
 uint32 Screen::getNextFrameTime() {
@@ -24,9 +24,9 @@
 #define NEVERHOOD_SCREEN_H
 
 #include "common/array.h"
+#include "graphics/microtiles.h"
 #include "graphics/surface.h"
 #include "neverhood/neverhood.h"
-#include "neverhood/microtiles.h"
 #include "neverhood/graphics.h"
 
 namespace Video {
@@ -91,7 +91,7 @@ public:
 	void blitRenderItem(const RenderItem &renderItem, const Common::Rect &clipRect);
 protected:
 	NeverhoodEngine *_vm;
-	MicroTileArray *_microTiles;
+	Graphics::MicroTileArray *_microTiles;
 	Graphics::Surface *_backScreen;
 	Video::SmackerDecoder *_smackerDecoder, *_savedSmackerDecoder;
 	int32 _ticks;
@@ -28,6 +28,7 @@
 #include "sci/event.h"
 #include "sci/resource.h"
 #include "sci/engine/state.h"
+#include "sci/engine/avoidpath.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
@@ -51,8 +52,10 @@
 #include "video/avi_decoder.h"
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
+#include "sci/sound/audio32.h"
 #include "video/coktel_decoder.h"
 #endif
 
@@ -121,6 +124,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("room",				WRAP_METHOD(Console, cmdRoomNumber));
 	registerCmd("quit",				WRAP_METHOD(Console, cmdQuit));
 	registerCmd("list_saves",			WRAP_METHOD(Console, cmdListSaves));
+	registerCmd("avoidpath_cache",	WRAP_METHOD(Console, cmdAvoidPathCache));
 	// Graphics
 	registerCmd("show_map",			WRAP_METHOD(Console, cmdShowMap));
 	registerCmd("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
@@ -143,6 +147,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -163,6 +168,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("startsound",			WRAP_METHOD(Console, cmdStartSound));
 	registerCmd("togglesound",		WRAP_METHOD(Console, cmdToggleSound));
 	registerCmd("stopallsounds",		WRAP_METHOD(Console, cmdStopAllSounds));
+	registerCmd("audio32_stats",		WRAP_METHOD(Console, cmdAudio32Stats));
 	registerCmd("sfx01_header",		WRAP_METHOD(Console, cmdSfx01Header));
 	registerCmd("sfx01_track",		WRAP_METHOD(Console, cmdSfx01Track));
 	registerCmd("show_instruments",	WRAP_METHOD(Console, cmdShowInstruments));
@@ -366,6 +372,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" save_game - Saves the current game state to the hard disk\n");
 	debugPrintf(" restore_game - Restores a saved game from the hard disk\n");
 	debugPrintf(" list_saves - List all saved games including filenames\n");
+	debugPrintf(" avoidpath_cache - Shows, toggles or benchmarks the pathfinding visibility graph cache\n");
 	debugPrintf(" restart_game - Restarts the game\n");
 	debugPrintf(" version - Shows the resource and interpreter versions\n");
 	debugPrintf(" room - Gets or sets the current room number\n");
@@ -387,6 +394,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows statistics of the cel cache, or clears it (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -405,6 +413,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" songinfo - Shows information about a specified song in the song library\n");
 	debugPrintf(" togglesound - Starts/stops a sound in the song library\n");
 	debugPrintf(" stopallsounds - Stops all sounds in the playlist\n");
+	debugPrintf(" audio32_stats - Shows how long the digital audio mixer waited for and held its lock (SCI2+)\n");
 	debugPrintf(" startsound - Starts the specified sound resource, replacing the first song in the song library\n");
 	debugPrintf(" is_sample - Shows information on a given sound resource, if it's a PCM sample\n");
 	debugPrintf(" sfx01_header - Dumps the header of a SCI01 song\n");
@@ -1366,6 +1375,53 @@ bool Console::cmdListSaves(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAvoidPathCache(int argc, const char **argv) {
+	AvoidPathCache *cache = _engine->_gamestate->_avoidPathCache;
+
+	if (argc < 2) {
+		debugPrintf("Shows statistics of the pathfinding visibility graph cache\n");
+		debugPrintf("Usage: %s stats|on|off|clear|record|bench [iterations]\n", argv[0]);
+		debugPrintf("record toggles recording of kAvoidPath calls, which bench replays\n");
+		debugPrintf("with a cold and a warm cache\n");
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "on")) {
+		cache->setEnabled(true);
+	} else if (!scumm_stricmp(argv[1], "off")) {
+		cache->setEnabled(false);
+		cache->clear();
+	} else if (!scumm_stricmp(argv[1], "clear")) {
+		cache->clear();
+	} else if (!scumm_stricmp(argv[1], "record")) {
+		cache->setRecording(!cache->isRecording());
+		if (cache->isRecording())
+			debugPrintf("Recording kAvoidPath calls, the last ones are kept for bench\n");
+		else
+			debugPrintf("Stopped recording, %u kAvoidPath calls recorded\n", cache->getRecordedInputCount());
+		return true;
+	} else if (!scumm_stricmp(argv[1], "bench")) {
+		if (!cache->getRecordedInputCount()) {
+			debugPrintf("No kAvoidPath calls have been recorded, use 'record' first\n");
+			return true;
+		}
+
+		uint iterations = (argc > 2) ? atoi(argv[2]) : 10;
+		uint32 coldTime, warmTime;
+		cache->runBenchmark(_engine->_gamestate, iterations, coldTime, warmTime);
+		debugPrintf("%u calls x %u iterations: cold %u ms, warm %u ms\n",
+			cache->getRecordedInputCount(), iterations, coldTime, warmTime);
+		return true;
+	} else if (scumm_stricmp(argv[1], "stats")) {
+		debugPrintf("Unknown option '%s'\n", argv[1]);
+		return true;
+	}
+
+	debugPrintf("Cache %s%s, %u graphs, %u hits, %u misses\n", cache->isEnabled() ? "enabled" : "disabled",
+		cache->isRecording() ? " and recording" : "", cache->getGraphCount(), cache->getHits(), cache->getMisses());
+	return true;
+}
+
 bool Console::cmdClassTable(int argc, const char **argv) {
 	debugPrintf("Available classes (parse a parameter to filter the table by a specific class):\n");
 
@@ -1783,6 +1839,34 @@ bool Console::cmdPlaneList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	CelCache *cache = CelObj::getCache();
+	if (!cache) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "clear")) {
+		cache->clear();
+		debugPrintf("Cel cache cleared\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows statistics of the cel cache\n");
+		debugPrintf("Usage: %s [clear]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 lookups = cache->getHits() + cache->getMisses();
+	debugPrintf("Cel cache: %u entries, %u of %u bytes used\n", cache->getNumEntries(), cache->getSize(), cache->getCapacity());
+	debugPrintf("%u hits, %u misses (%u%% hit rate)\n", cache->getHits(), cache->getMisses(),
+		lookups ? cache->getHits() * 100 / lookups : 0);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdVisiblePlaneList(int argc, const char **argv) {
 #ifdef ENABLE_SCI32
 	if (_engine->_gfxFrameout) {
@@ -2383,6 +2467,35 @@ bool Console::cmdStopAllSounds(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAudio32Stats(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!g_sci->_audio32) {
+		debugPrintf("This SCI version does not use the SCI32 audio mixer\n");
+		return true;
+	}
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		g_sci->_audio32->resetMixerLockStats();
+		debugPrintf("Mixer lock statistics have been reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows statistics about the SCI32 audio mixer lock\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	Audio32::MixerLockStats stats;
+	g_sci->_audio32->getMixerLockStats(stats);
+
+	debugPrintf("Mixer callbacks: %u, stalled for 1 ms or more: %u\n", stats.numLocks, stats.numLongWaits);
+	debugPrintf("Lock wait time: %u ms total, %u ms max\n", stats.totalWaitTime, stats.maxWaitTime);
+	debugPrintf("Lock hold time: %u ms total, %u ms max\n", stats.totalHoldTime, stats.maxHoldTime);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdIsSample(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Tests whether a given sound resource is a PCM sample, \n");
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_AVOIDPATH_H
+#define SCI_ENGINE_AVOIDPATH_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+struct EngineState;
+
+/**
+ * Cache of the visibility graphs computed by kAvoidPath.
+ *
+ * Games call kAvoidPath over and over with the same polygon list while
+ * actors walk around. The visibility between two polygon vertices only
+ * depends on the polygon geometry, so it is memoised here, keyed by the
+ * contents of the polygon set. Only the start and end points of each call
+ * are connected to the graph from scratch.
+ */
+class AvoidPathCache {
+public:
+	/**
+	 * The visibility graph of a polygon set. Rows are filled in lazily, as
+	 * the A* search expands the corresponding vertices.
+	 */
+	struct Graph {
+		Common::Array<int16> key;
+		uint size;
+		Common::Array<byte> rowValid;
+		Common::Array<byte> visible;
+
+		Graph(const Common::Array<int16> &key_, uint size_);
+
+		bool isRowValid(uint row) const { return rowValid[row] != 0; }
+		bool isVisible(uint row, uint column) const { return visible[row * size + column] != 0; }
+	};
+
+	/**
+	 * A kAvoidPath input, as recorded for the benchmark.
+	 */
+	struct Input {
+		Common::Array<int16> polygons; ///< type, vertex count and vertices of each polygon
+		Common::Point start;
+		Common::Point end;
+		int width;
+		int height;
+		int opt;
+	};
+
+	AvoidPathCache();
+	~AvoidPathCache();
+
+	/**
+	 * Returns the visibility graph for the polygon set identified by the
+	 * given key, creating an empty one if necessary.
+	 * @return the graph, or NULL when caching is disabled
+	 */
+	Graph *getGraph(const Common::Array<int16> &key, uint size);
+
+	/**
+	 * Drops all cached visibility graphs.
+	 */
+	void clear();
+
+	void setEnabled(bool enabled) { _enabled = enabled; }
+	bool isEnabled() const { return _enabled; }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint getGraphCount() const { return _graphs.size(); }
+
+	/**
+	 * Starts or stops recording kAvoidPath inputs for the benchmark.
+	 * Starting drops the inputs recorded before.
+	 */
+	void setRecording(bool recording);
+	bool isRecording() const { return _recording; }
+
+	void recordInput(const Input &input);
+	uint getRecordedInputCount() const { return _inputs.size(); }
+
+	/**
+	 * Replays the recorded kAvoidPath inputs, once with an empty cache
+	 * before every call (cold) and once with a primed cache (warm).
+	 * @param s				the game state
+	 * @param iterations	the number of times each input is replayed
+	 * @param coldTime		total time taken by the cold runs, in ms
+	 * @param warmTime		total time taken by the warm runs, in ms
+	 */
+	void runBenchmark(EngineState *s, uint iterations, uint32 &coldTime, uint32 &warmTime);
+
+private:
+	enum {
+		kMaxGraphs = 8,
+		kMaxRecordedInputs = 64
+	};
+
+	/** Cached graphs, most recently used first */
+	Common::List<Graph *> _graphs;
+	Common::List<Input> _inputs;
+
+	bool _enabled;
+	bool _recording;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_AVOIDPATH_H
@@ -22,6 +22,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/state.h"
+#include "sci/engine/avoidpath.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
 #include "sci/graphics/paint16.h"
@@ -111,10 +112,15 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index in the cached visibility graph, or -1 for vertices that were
+	// added for the start and end points
+	int _staticIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		_staticIndex = -1;
 	}
 };
 
@@ -257,6 +263,15 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Polygon vertices, indexed by their position in the visibility graph
+	Common::Array<Vertex *> _staticVertices;
+
+	// Cached visibility graph of the polygon vertices, or NULL
+	AvoidPathCache::Graph *_visibility;
+
+	// Set when merging the start or end point split up a polygon edge
+	bool _edgeSplit;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -264,6 +279,8 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_visibility = NULL;
+		_edgeSplit = false;
 	}
 
 	~PathfindingState() {
@@ -659,42 +676,69 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether or not two vertices can see each other
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @param vertex		the other vertex
+ * @return true if vertex is visible from vertex_cur, false otherwise
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
+ * Visibility between two polygon vertices is taken from the cached
+ * visibility graph when there is one, so that only the start and end
+ * points have to be connected on every call.
  * @param s				the pathfinding state
  * @param vertex_cur	the vertex
  * @return list of vertices that are visible from vert
  */
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
+	AvoidPathCache::Graph *graph = (vertex_cur->_staticIndex >= 0) ? s->_visibility : NULL;
+	uint row = vertex_cur->_staticIndex;
+
+	if (graph && !graph->isRowValid(row)) {
+		for (uint i = 0; i < graph->size; i++)
+			graph->visible[row * graph->size + i] = vertex_visible(s, vertex_cur, s->_staticVertices[i]);
+		graph->rowValid[row] = 1;
+	}
 
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
+		bool visible;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
+		if (graph && vertex->_staticIndex >= 0)
+			visible = graph->isVisible(row, vertex->_staticIndex);
+		else
+			visible = vertex_visible(s, vertex_cur, vertex);
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1083,6 +1127,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_edgeSplit = true;
 					return v_new;
 				}
 			}
@@ -1186,39 +1231,59 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
- * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
- *             (Common::Point) start: The start point
- *             (Common::Point) end: The end point
- *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ * Appends the vertices of a polygon set to an array, as used for recording
+ * kAvoidPath inputs and as key of the visibility graph cache
+ * Parameters: (const PolygonList &) polygons: The polygons
+ *             (Common::Array<int16> &) out: The array to append to
+ *             (bool) withType: Whether to include the polygon types
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
-	Polygon *polygon;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
+static void serialize_polygons(const PolygonList &polygons, Common::Array<int16> &out, bool withType) {
+	for (PolygonList::const_iterator it = polygons.begin(); it != polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
+		if (withType)
+			out.push_back(polygon->type);
+		out.push_back(polygon->vertices.size());
 
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			out.push_back(vertex->v.x);
+			out.push_back(vertex->v.y);
+		}
+	}
+}
 
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
+/**
+ * Rebuilds a polygon set stored by serialize_polygons() with types
+ * Parameters: (const Common::Array<int16> &) in: The serialized polygons
+ *             (PolygonList &) polygons: The list to append the polygons to
+ */
+static void deserialize_polygons(const Common::Array<int16> &in, PolygonList &polygons) {
+	uint pos = 0;
 
-			node = s->_segMan->lookupNode(node->succ);
-		}
+	while (pos < in.size()) {
+		Polygon *polygon = new Polygon(in[pos++]);
+		int size = in[pos++];
+
+		for (int i = 0; i < size; i++, pos += 2)
+			polygon->vertices.insertAtEnd(new Vertex(Common::Point(in[pos], in[pos + 1])));
+
+		polygons.push_back(polygon);
 	}
+}
+
+/**
+ * Prepares a pathfinding state for the A* search, once its polygons have
+ * been set up
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (bool) true on success, false otherwise
+ */
+static bool prepare_polygon_set(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt) {
+	Polygon *polygon;
 
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
@@ -1227,8 +1292,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	if (!new_start) {
 		warning("AvoidPath: Couldn't fixup start position for pathfinding");
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	Common::Point *new_end = fixup_end_point(pf_s, end);
@@ -1236,8 +1300,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	if (!new_end) {
 		warning("AvoidPath: Couldn't fixup end position for pathfinding");
 		delete new_start;
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	if (opt == 0) {
@@ -1259,8 +1322,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 				warning("AvoidPath: error finding nearest intersection");
 				delete new_start;
 				delete new_end;
-				delete pf_s;
-				return NULL;
+				return false;
 			}
 
 			if (err == PF_OK)
@@ -1276,6 +1338,20 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Number the remaining polygon vertices for the visibility graph
+	Common::Array<int16> key;
+	serialize_polygons(pf_s->polygons, key, false);
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->_staticIndex = pf_s->_staticVertices.size();
+			pf_s->_staticVertices.push_back(vertex);
+		}
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1283,8 +1359,18 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_start;
 	delete new_end;
 
+	// Splitting an edge changes the visibility between the polygon
+	// vertices, so the cached graph can only be used if that didn't happen
+	if (!pf_s->_edgeSplit)
+		pf_s->_visibility = s->_avoidPathCache->getGraph(key, pf_s->_staticVertices.size());
+
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	int count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1299,6 +1385,58 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	pf_s->vertices = count;
 
+	return true;
+}
+
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	// Keep the input around for the benchmark of the avoidpath_cache
+	// console command, but only while it is recording
+	if (s->_avoidPathCache->isRecording()) {
+		AvoidPathCache::Input input;
+		serialize_polygons(pf_s->polygons, input.polygons, true);
+		input.start = start;
+		input.end = end;
+		input.width = width;
+		input.height = height;
+		input.opt = opt;
+		s->_avoidPathCache->recordInput(input);
+	}
+
+	if (!prepare_polygon_set(s, pf_s, start, end, opt)) {
+		delete pf_s;
+		return NULL;
+	}
+
 	return pf_s;
 }
 
@@ -1485,6 +1623,101 @@ static reg_t output_path(PathfindingState *p, EngineState *s) {
 	return output;
 }
 
+AvoidPathCache::Graph::Graph(const Common::Array<int16> &key_, uint size_) : key(key_), size(size_) {
+	rowValid.resize(size);
+	visible.resize(size * size);
+	for (uint i = 0; i < size; i++)
+		rowValid[i] = 0;
+}
+
+AvoidPathCache::AvoidPathCache() : _enabled(true), _recording(false), _hits(0), _misses(0) {
+}
+
+AvoidPathCache::~AvoidPathCache() {
+	clear();
+}
+
+AvoidPathCache::Graph *AvoidPathCache::getGraph(const Common::Array<int16> &key, uint size) {
+	if (!_enabled)
+		return NULL;
+
+	for (Common::List<Graph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it) {
+		Graph *graph = *it;
+
+		if (graph->size == size && graph->key == key) {
+			// Move to the front of the list
+			_graphs.erase(it);
+			_graphs.push_front(graph);
+			_hits++;
+			return graph;
+		}
+	}
+
+	if (_graphs.size() >= kMaxGraphs) {
+		delete _graphs.back();
+		_graphs.pop_back();
+	}
+
+	Graph *graph = new Graph(key, size);
+	_graphs.push_front(graph);
+	_misses++;
+	return graph;
+}
+
+void AvoidPathCache::clear() {
+	for (Common::List<Graph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it)
+		delete *it;
+	_graphs.clear();
+}
+
+void AvoidPathCache::setRecording(bool recording) {
+	_recording = recording;
+	if (recording)
+		_inputs.clear();
+}
+
+void AvoidPathCache::recordInput(const Input &input) {
+	if (_inputs.size() >= kMaxRecordedInputs)
+		_inputs.pop_front();
+	_inputs.push_back(input);
+}
+
+void AvoidPathCache::runBenchmark(EngineState *s, uint iterations, uint32 &coldTime, uint32 &warmTime) {
+	const uint32 hits = _hits;
+	const uint32 misses = _misses;
+
+	coldTime = warmTime = 0;
+
+	for (int pass = 0; pass < 2; pass++) {
+		const bool warm = (pass == 1);
+		uint32 startTime = g_system->getMillis();
+
+		for (uint i = 0; i < iterations; i++) {
+			for (Common::List<Input>::const_iterator it = _inputs.begin(); it != _inputs.end(); ++it) {
+				if (!warm)
+					clear();
+
+				PathfindingState *p = new PathfindingState(it->width, it->height);
+				deserialize_polygons(it->polygons, p->polygons);
+
+				if (prepare_polygon_set(s, p, it->start, it->end, it->opt))
+					AStar(p);
+
+				delete p;
+			}
+		}
+
+		if (warm)
+			warmTime = g_system->getMillis() - startTime;
+		else
+			coldTime = g_system->getMillis() - startTime;
+	}
+
+	// Don't let the benchmark skew the statistics of the game itself
+	_hits = hits;
+	_misses = misses;
+}
+
 reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	Common::Point start = Common::Point(argv[0].toSint16(), argv[1].toSint16());
 
@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/config-manager.h"
+
 #include "sci/resource.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
@@ -88,20 +90,18 @@ bool CelObj::_drawBlackLines = false;
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler = new CelScaler();
-	_cache = new CelCache;
-	_cache->resize(100);
+
+	uint32 cacheSize = kDefaultCelCacheSize;
+	if (ConfMan.hasKey("cel_cache_size")) {
+		cacheSize = MAX(ConfMan.getInt("cel_cache_size"), 0);
+	}
+	_cache = new CelCache(cacheSize);
 }
 
 void CelObj::deinit() {
 	delete _scaler;
 	_scaler = nullptr;
-	if (_cache != nullptr) {
-		for (CelCache::iterator it = _cache->begin(); it != _cache->end(); ++it) {
-			delete it->celObj;
-		}
-	}
 	delete _cache;
 	_cache = nullptr;
 }
@@ -578,50 +578,101 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+CelObj *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	return _cache->find(celInfo);
+}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+void CelObj::putCopyInCache(const uint32 size) const {
+	_cache->insert(duplicate(), size);
+}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
+CelCache::CelCache(const uint32 capacity) :
+	_capacity(capacity),
+	_size(0),
+	_head(nullptr),
+	_tail(nullptr),
+	_hits(0),
+	_misses(0) {}
+
+CelCache::~CelCache() {
+	clear();
+}
+
+CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	EntryMap::iterator it = _entries.find(celInfo);
+	if (it == _entries.end()) {
+		++_misses;
+		return nullptr;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	++_hits;
+	CelCacheEntry *const entry = it->_value;
+	if (entry != _head) {
+		detach(entry);
+		attachAtFront(entry);
 	}
+	return entry->celObj;
+}
 
-	return -1;
+void CelCache::insert(CelObj *const celObj, const uint32 size) {
+	EntryMap::iterator it = _entries.find(celObj->_info);
+	if (it != _entries.end()) {
+		remove(it->_value);
+	}
+
+	CelCacheEntry *const entry = new CelCacheEntry;
+	entry->celObj = celObj;
+	entry->size = size + sizeof(CelCacheEntry);
+	attachAtFront(entry);
+	_entries.setVal(celObj->_info, entry);
+	_size += entry->size;
+
+	// The newly inserted cel is always kept, even if it
+	// exceeds the capacity on its own
+	while (_size > _capacity && _tail != entry) {
+		remove(_tail);
+	}
+}
+
+void CelCache::clear() {
+	while (_head != nullptr) {
+		remove(_head);
+	}
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+void CelCache::detach(CelCacheEntry *const entry) {
+	if (entry->prev != nullptr) {
+		entry->prev->next = entry->next;
+	} else {
+		_head = entry->next;
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
+	if (entry->next != nullptr) {
+		entry->next->prev = entry->prev;
+	} else {
+		_tail = entry->prev;
+	}
+}
 
-	if (entry.celObj != nullptr) {
-		delete entry.celObj;
+void CelCache::attachAtFront(CelCacheEntry *const entry) {
+	entry->prev = nullptr;
+	entry->next = _head;
+	if (_head != nullptr) {
+		_head->prev = entry;
+	} else {
+		_tail = entry;
 	}
+	_head = entry;
+}
 
-	entry.celObj = duplicate();
-	entry.id = ++_nextCacheId;
+void CelCache::remove(CelCacheEntry *const entry) {
+	detach(entry);
+	_entries.erase(entry->celObj->_info);
+	_size -= entry->size;
+	delete entry->celObj;
+	delete entry;
 }
 
 #pragma mark -
@@ -843,16 +894,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj);
+	CelObj *const cacheEntry = searchCache(_info);
+	if (cacheEntry != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(cacheEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in cel cache for %d", _info.resourceId);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -957,7 +1005,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache(sizeof(CelObjView));
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1023,16 +1071,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj);
+	CelObj *const cacheEntry = searchCache(_info);
+	if (cacheEntry != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(cacheEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in cel cache for %d", _info.resourceId);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1097,7 +1142,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache(sizeof(CelObjPic));
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource.h"
@@ -109,7 +110,7 @@ struct CelInfo32 {
 	// NOTE: This is the equivalence criteria used by
 	// CelObj::searchCache in at least SCI2.1/SQ6. Notably,
 	// it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -119,24 +120,105 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 };
 
+enum {
+	/**
+	 * The default capacity of the cel cache, in bytes.
+	 * Cached cel objects only hold metadata about the cel,
+	 * so this is enough for several hundred cels.
+	 */
+	kDefaultCelCacheSize = 64 * 1024
+};
+
+struct CelInfo32Hash : public Common::UnaryFunction<CelInfo32, uint> {
+	uint operator()(const CelInfo32 &info) const {
+		return ((uint)info.type << 28) ^ ((uint16)info.resourceId << 12) ^ ((uint16)info.loopNo << 6) ^
+			(uint16)info.celNo ^ (info.bitmap.getSegment() << 16) ^ info.bitmap.getOffset();
+	}
+};
+
 class CelObj;
 struct CelCacheEntry {
+	CelObj *celObj;
+
 	/**
-	 * A monotonically increasing cache ID used to identify
-	 * the least recently used item in the cache for
-	 * replacement.
+	 * The number of bytes this entry counts against the
+	 * capacity of the cache.
 	 */
-	int id;
-	CelObj *celObj;
-	CelCacheEntry() : id(0), celObj(nullptr) {}
+	uint32 size;
+
+	/**
+	 * Neighbours in the LRU list of the cache, from most
+	 * to least recently used.
+	 */
+	CelCacheEntry *prev, *next;
 };
 
-typedef Common::Array<CelCacheEntry> CelCache;
+/**
+ * A cache of cel objects, indexed by CelInfo32. When the
+ * total size of the cached objects exceeds the capacity of
+ * the cache, the least recently used cels are evicted.
+ */
+class CelCache {
+public:
+	CelCache(const uint32 capacity);
+	~CelCache();
+
+	/**
+	 * Returns the cached cel object matching the given
+	 * CelInfo32 and marks it as most recently used, or
+	 * returns null if there is no such cel.
+	 */
+	CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Puts the given cel object into the cache, taking
+	 * ownership of it and replacing any object with the
+	 * same CelInfo32.
+	 */
+	void insert(CelObj *const celObj, const uint32 size);
+
+	/**
+	 * Removes all cel objects from the cache.
+	 */
+	void clear();
+
+	uint32 getCapacity() const { return _capacity; }
+	uint32 getSize() const { return _size; }
+	uint getNumEntries() const { return _entries.size(); }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+
+private:
+	typedef Common::HashMap<CelInfo32, CelCacheEntry *, CelInfo32Hash> EntryMap;
+
+	void detach(CelCacheEntry *const entry);
+	void attachAtFront(CelCacheEntry *const entry);
+	void remove(CelCacheEntry *const entry);
+
+	/**
+	 * The maximum number of bytes held by the cache.
+	 */
+	uint32 _capacity;
+
+	/**
+	 * The number of bytes currently held by the cache.
+	 */
+	uint32 _size;
+
+	EntryMap _entries;
+
+	/**
+	 * The most and least recently used entries.
+	 */
+	CelCacheEntry *_head, *_tail;
+
+	uint32 _hits, _misses;
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -445,35 +527,34 @@ private:
 
 #pragma mark -
 #pragma mark CelObj - Caching
-protected:
+public:
 	/**
-	 * A monotonically increasing cache ID used to identify
-	 * the least recently used item in the cache for
-	 * replacement.
+	 * Returns the cel cache, for inspection by the
+	 * debugger.
 	 */
-	static int _nextCacheId;
+	static CelCache *getCache() { return _cache; }
 
+protected:
 	/**
 	 * A cache of cel objects used to avoid reinitialisation
 	 * overhead for cels with the same CelInfo32.
 	 */
-	// NOTE: At least SQ6 uses a fixed cache size of 100.
+	// NOTE: At least SQ6 uses a fixed cache size of 100
+	// entries. We use a capacity in bytes instead, which can
+	// be set with the `cel_cache_size` config key.
 	static CelCache *_cache;
 
 	/**
 	 * Searches the cel cache for a CelObj matching the
-	 * provided CelInfo32. If not found, -1 is returned.
-	 * nextInsertIndex will receive the index of the oldest
-	 * item in the cache, which can be used to replace
-	 * the oldest item with a newer item.
+	 * provided CelInfo32. If not found, null is returned.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	CelObj *searchCache(const CelInfo32 &celInfo) const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the
-	 * given cache index.
+	 * Puts a copy of this CelObj into the cache. `size`
+	 * is the size of the concrete cel object type.
 	 */
-	void putCopyInCache(int index) const;
+	void putCopyInCache(const uint32 size) const;
 };
 
 #pragma mark -
@@ -233,8 +233,30 @@ int Audio32::writeAudioInternal(Audio::AudioStream *const sourceStream, Audio::R
 // all these original functions is combined here and
 // simplified.
 int Audio32::readBuffer(Audio::st_sample_t *buffer, const int numSamples) {
+	// Any time spent waiting for the lock here is time that the
+	// mixer thread is stalled by the game thread, so it is
+	// recorded for the `audio32_stats` debugger command
+	const uint32 requestedAt = g_system->getMillis();
 	Common::StackLock lock(_mutex);
+	const uint32 lockedAt = g_system->getMillis();
 
+	const int samplesWritten = mixChannels(buffer, numSamples);
+
+	const uint32 waitTime = lockedAt - requestedAt;
+	const uint32 holdTime = g_system->getMillis() - lockedAt;
+	++_mixerLockStats.numLocks;
+	if (waitTime) {
+		++_mixerLockStats.numLongWaits;
+	}
+	_mixerLockStats.totalWaitTime += waitTime;
+	_mixerLockStats.maxWaitTime = MAX(_mixerLockStats.maxWaitTime, waitTime);
+	_mixerLockStats.totalHoldTime += holdTime;
+	_mixerLockStats.maxHoldTime = MAX(_mixerLockStats.maxHoldTime, holdTime);
+
+	return samplesWritten;
+}
+
+int Audio32::mixChannels(Audio::st_sample_t *buffer, const int numSamples) {
 	if (_pausedAtTick != 0 || _numActiveChannels == 0) {
 		return 0;
 	}
@@ -506,13 +528,30 @@ void Audio32::freeChannel(const int16 channelIndex) {
 }
 
 void Audio32::unlockResources() {
-	Common::StackLock lock(_mutex);
-	assert(!_inAudioThread);
+	UnlockList resourcesToUnlock;
 
-	for (UnlockList::const_iterator it = _resourcesToUnlock.begin(); it != _resourcesToUnlock.end(); ++it) {
+	{
+		Common::StackLock lock(_mutex);
+		assert(!_inAudioThread);
+		SWAP(resourcesToUnlock, _resourcesToUnlock);
+	}
+
+	// The resources are no longer referenced by any channel,
+	// so they can be unlocked without blocking the mixer
+	// (unless the caller already holds the lock)
+	for (UnlockList::const_iterator it = resourcesToUnlock.begin(); it != resourcesToUnlock.end(); ++it) {
 		_resMan->unlockResource(*it);
 	}
-	_resourcesToUnlock.clear();
+}
+
+void Audio32::getMixerLockStats(MixerLockStats &stats) const {
+	Common::StackLock lock(_mutex);
+	stats = _mixerLockStats;
+}
+
+void Audio32::resetMixerLockStats() {
+	Common::StackLock lock(_mutex);
+	_mixerLockStats = MixerLockStats();
 }
 
 #pragma mark -
@@ -651,26 +690,28 @@ bool Audio32::stopRobotAudio() {
 #pragma mark Playback
 
 uint16 Audio32::play(int16 channelIndex, const ResourceId resourceId, const bool autoPlay, const bool loop, const int16 volume, const reg_t soundNode, const bool monitor) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	freeUnusedChannels();
+		freeUnusedChannels();
 
-	if (channelIndex != kNoExistingChannel) {
-		AudioChannel &channel = getChannel(channelIndex);
-		Audio::SeekableAudioStream *stream = dynamic_cast<Audio::SeekableAudioStream *>(channel.stream);
+		if (channelIndex != kNoExistingChannel) {
+			AudioChannel &channel = getChannel(channelIndex);
+			Audio::SeekableAudioStream *stream = dynamic_cast<Audio::SeekableAudioStream *>(channel.stream);
 
-		if (channel.pausedAtTick) {
-			resume(channelIndex);
+			if (channel.pausedAtTick) {
+				resume(channelIndex);
+				return MIN(65534, 1 + stream->getLength().msecs() * 60 / 1000);
+			}
+
+			warning("Tried to resume channel %s that was not paused", channel.id.toString().c_str());
 			return MIN(65534, 1 + stream->getLength().msecs() * 60 / 1000);
 		}
 
-		warning("Tried to resume channel %s that was not paused", channel.id.toString().c_str());
-		return MIN(65534, 1 + stream->getLength().msecs() * 60 / 1000);
-	}
-
-	if (_numActiveChannels == _channels.size()) {
-		warning("Audio mixer is full when trying to play %s", resourceId.toString().c_str());
-		return 0;
+		if (_numActiveChannels == _channels.size()) {
+			warning("Audio mixer is full when trying to play %s", resourceId.toString().c_str());
+			return 0;
+		}
 	}
 
 	// NOTE: SCI engine itself normally searches in this order:
@@ -710,35 +751,24 @@ uint16 Audio32::play(int16 channelIndex, const ResourceId resourceId, const bool
 	// TODO: This should be fixed to use streaming, which means
 	// fixing the resource manager to allow streaming, which means
 	// probably rewriting a bunch of the resource manager.
+	//
+	// Loading the resource and setting up its streams may need to
+	// read from disk, so this is done without holding the lock to
+	// avoid stalling the mixer thread. The new channel is only
+	// published to the mixer once it is completely set up.
 	Resource *resource = _resMan->findResource(resourceId, true);
 	if (resource == nullptr) {
 		return 0;
 	}
 
-	channelIndex = _numActiveChannels++;
-
-	AudioChannel &channel = getChannel(channelIndex);
-	channel.id = resourceId;
-	channel.resource = resource;
-	channel.loop = loop;
-	channel.robot = false;
-	channel.fadeStartTick = 0;
-	channel.soundNode = soundNode;
-	channel.volume = volume < 0 || volume > kMaxVolume ? (int)kMaxVolume : volume;
-	// TODO: SCI3 introduces stereo audio
-	channel.pan = -1;
-
-	if (monitor) {
-		_monitoredChannelIndex = channelIndex;
-	}
-
 	Common::MemoryReadStream headerStream(resource->_header, resource->_headerSize, DisposeAfterUse::NO);
-	Common::SeekableReadStream *dataStream = channel.resourceStream = resource->makeStream();
+	Common::SeekableReadStream *dataStream = resource->makeStream();
+	Audio::AudioStream *audioStream;
 
 	if (detectSolAudio(headerStream)) {
-		channel.stream = makeSOLStream(&headerStream, dataStream, DisposeAfterUse::NO);
+		audioStream = makeSOLStream(&headerStream, dataStream, DisposeAfterUse::NO);
 	} else if (detectWaveAudio(*dataStream)) {
-		channel.stream = Audio::makeWAVStream(dataStream, DisposeAfterUse::NO);
+		audioStream = Audio::makeWAVStream(dataStream, DisposeAfterUse::NO);
 	} else {
 		byte flags = Audio::FLAG_LITTLE_ENDIAN;
 		if (_globalBitDepth == 16) {
@@ -751,10 +781,10 @@ uint16 Audio32::play(int16 channelIndex, const ResourceId resourceId, const bool
 			flags |= Audio::FLAG_STEREO;
 		}
 
-		channel.stream = Audio::makeRawStream(dataStream, _globalSampleRate, flags, DisposeAfterUse::NO);
+		audioStream = Audio::makeRawStream(dataStream, _globalSampleRate, flags, DisposeAfterUse::NO);
 	}
 
-	channel.converter = Audio::makeRateConverter(channel.stream->getRate(), getRate(), channel.stream->isStereo(), false);
+	Audio::RateConverter *converter = Audio::makeRateConverter(audioStream->getRate(), getRate(), audioStream->isStereo(), false);
 
 	// NOTE: SCI engine sets up a decompression buffer here for the audio
 	// stream, plus writes information about the sample to the channel to
@@ -764,7 +794,32 @@ uint16 Audio32::play(int16 channelIndex, const ResourceId resourceId, const bool
 	// use audio streams, and allocate and fill the monitoring buffer
 	// when reading audio data from the stream.
 
-	channel.duration = /* round up */ 1 + (dynamic_cast<Audio::SeekableAudioStream *>(channel.stream)->getLength().msecs() * 60 / 1000);
+	const uint32 duration = /* round up */ 1 + (dynamic_cast<Audio::SeekableAudioStream *>(audioStream)->getLength().msecs() * 60 / 1000);
+
+	Common::StackLock lock(_mutex);
+
+	// Channels are only ever added from this thread, so the
+	// capacity check above still holds
+	channelIndex = _numActiveChannels++;
+
+	AudioChannel &channel = getChannel(channelIndex);
+	channel.id = resourceId;
+	channel.resource = resource;
+	channel.resourceStream = dataStream;
+	channel.stream = audioStream;
+	channel.converter = converter;
+	channel.duration = duration;
+	channel.loop = loop;
+	channel.robot = false;
+	channel.fadeStartTick = 0;
+	channel.soundNode = soundNode;
+	channel.volume = volume < 0 || volume > kMaxVolume ? (int)kMaxVolume : volume;
+	// TODO: SCI3 introduces stereo audio
+	channel.pan = -1;
+
+	if (monitor) {
+		_monitoredChannelIndex = channelIndex;
+	}
 
 	const uint32 now = g_sci->getTickCount();
 	channel.pausedAtTick = autoPlay ? 0 : now;
@@ -182,7 +182,61 @@ public:
 	bool endOfData() const { return _numActiveChannels == 0; }
 	bool endOfStream() const { return false; }
 
+	/**
+	 * Statistics about the use of the mixer lock by the
+	 * audio thread. Times are in milliseconds.
+	 */
+	struct MixerLockStats {
+		/**
+		 * The number of times the mixer thread took the lock.
+		 */
+		uint32 numLocks;
+
+		/**
+		 * The number of times the mixer thread waited one
+		 * millisecond or more for another thread to release
+		 * the lock. Shorter waits are below the resolution of
+		 * the timer and are not counted.
+		 */
+		uint32 numLongWaits;
+
+		uint32 totalWaitTime;
+		uint32 maxWaitTime;
+		uint32 totalHoldTime;
+		uint32 maxHoldTime;
+
+		MixerLockStats() :
+			numLocks(0),
+			numLongWaits(0),
+			totalWaitTime(0),
+			maxWaitTime(0),
+			totalHoldTime(0),
+			maxHoldTime(0) {}
+	};
+
+	/**
+	 * Gets a copy of the current mixer lock statistics.
+	 */
+	void getMixerLockStats(MixerLockStats &stats) const;
+
+	/**
+	 * Resets the mixer lock statistics.
+	 */
+	void resetMixerLockStats();
+
 private:
+	/**
+	 * Statistics about the use of the mixer lock by the
+	 * audio thread.
+	 */
+	MixerLockStats _mixerLockStats;
+
+	/**
+	 * Mixes all active channels into the given buffer. The
+	 * caller must hold the mixer lock.
+	 */
+	int mixChannels(Audio::st_sample_t *buffer, const int numSamples);
+
 	/**
 	 * Mixes audio from the given source stream into the
 	 * target buffer using the given rate converter.
@@ -248,19 +302,19 @@ private:
 	UnlockList _resourcesToUnlock;
 
 	/**
-	 * Gets the audio channel at the given index.
+	 * Gets the audio channel at the given index. The
+	 * caller must hold the mixer lock.
 	 */
 	inline AudioChannel &getChannel(const int16 channelIndex) {
-		Common::StackLock lock(_mutex);
 		assert(channelIndex >= 0 && channelIndex < _numActiveChannels);
 		return _channels[channelIndex];
 	}
 
 	/**
-	 * Gets the audio channel at the given index.
+	 * Gets the audio channel at the given index. The
+	 * caller must hold the mixer lock.
 	 */
 	inline const AudioChannel &getChannel(const int16 channelIndex) const {
-		Common::StackLock lock(_mutex);
 		assert(channelIndex >= 0 && channelIndex < _numActiveChannels);
 		return _channels[channelIndex];
 	}
@@ -30,6 +30,11 @@
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
 #include "scumm/imuse/imuse.h"
+#ifdef ENABLE_SCUMM_7_8
+#include "scumm/imuse_digi/dimuse.h"
+#include "scumm/imuse_digi/dimuse_bndmgr.h"
+#include "scumm/imuse_digi/dimuse_sndmgr.h"
+#endif
 #include "scumm/object.h"
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
@@ -166,6 +171,16 @@ bool ScummDebugger::Cmd_IMuse(int argc, const char **argv) {
 				debugPrintf("Specify a music resource # or \"all\".\n");
 			}
 			return true;
+#ifdef ENABLE_SCUMM_7_8
+		} else if (!strcmp(argv[1], "bundles")) {
+			if (!_vm->_imuseDigital) {
+				debugPrintf("No iMuse Digital engine is active.\n");
+				return true;
+			}
+			const BundleDirCache::DecodeStats &stats = _vm->_imuseDigital->getSoundMgr()->getBundleDirCache()->getDecodeStats();
+			debugPrintf("Bundle blocks decoded: %u, cache hits: %u\n", stats.blocksDecoded, stats.blockCacheHits);
+			return true;
+#endif
 		}
 	}
 
@@ -173,6 +188,9 @@ bool ScummDebugger::Cmd_IMuse(int argc, const char **argv) {
 	debugPrintf("  panic - Stop all music tracks\n");
 	debugPrintf("  play # - Play a music resource\n");
 	debugPrintf("  stop # - Stop a music resource\n");
+#ifdef ENABLE_SCUMM_7_8
+	debugPrintf("  bundles - Show bundle decoding statistics\n");
+#endif
 	return true;
 }
 
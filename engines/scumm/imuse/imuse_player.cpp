@@ -191,6 +191,7 @@ int Player::start_seq_sound(int sound, bool reset_vars) {
 	} else {
 		// SCUMM SMF resource
 		_parser = MidiParser::createParser_SMF();
+		_parser->property(MidiParser::mpIndexedJumps, 1);
 	}
 
 	_parser->setMidiDriver(this);
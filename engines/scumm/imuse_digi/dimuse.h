@@ -127,6 +127,8 @@ public:
 
 	void setAudioNames(int32 num, char *names);
 
+	ImuseDigiSndMgr *getSoundMgr() { return _sound; }
+
 	void startVoice(int soundId, Audio::AudioStream *input);
 	void startVoice(int soundId, const char *soundName);
 	void startMusic(int soundId, int volume);
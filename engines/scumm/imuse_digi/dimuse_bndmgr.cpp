@@ -37,13 +37,17 @@ BundleDirCache::BundleDirCache() {
 		_budleDirCache[fileId].numFiles = 0;
 		_budleDirCache[fileId].isCompressed = false;
 		_budleDirCache[fileId].indexTable = NULL;
+		_budleDirCache[fileId].decodedBlocks = NULL;
 	}
+	_blockUseCounter = 0;
+	memset(&_stats, 0, sizeof(_stats));
 }
 
 BundleDirCache::~BundleDirCache() {
 	for (int fileId = 0; fileId < ARRAYSIZE(_budleDirCache); fileId++) {
 		free(_budleDirCache[fileId].bundleTable);
 		free(_budleDirCache[fileId].indexTable);
+		free(_budleDirCache[fileId].decodedBlocks);
 	}
 }
 
@@ -63,6 +67,56 @@ bool BundleDirCache::isSndDataExtComp(int slot) {
 	return _budleDirCache[slot].isCompressed;
 }
 
+const byte *BundleDirCache::findDecodedBlock(int slot, int32 index, int32 block, int32 &size) {
+	DecodedBlock *blocks = _budleDirCache[slot].decodedBlocks;
+	if (!blocks)
+		return NULL;
+
+	for (int i = 0; i < kMaxDecodedBlocks; i++) {
+		if (blocks[i].index == index && blocks[i].block == block) {
+			blocks[i].lastUsed = ++_blockUseCounter;
+			_stats.blockCacheHits++;
+			size = blocks[i].size;
+			return blocks[i].data;
+		}
+	}
+
+	return NULL;
+}
+
+void BundleDirCache::storeDecodedBlock(int slot, int32 index, int32 block, const byte *data, int32 size) {
+	assert(size <= 0x2000);
+
+	_stats.blocksDecoded++;
+
+	// Blocks are shared by all tracks playing from the same bundle, e.g.
+	// the two tracks of a music crossfade, so only decode them once
+	DecodedBlock *&blocks = _budleDirCache[slot].decodedBlocks;
+	if (!blocks) {
+		blocks = (DecodedBlock *)malloc(kMaxDecodedBlocks * sizeof(DecodedBlock));
+		assert(blocks);
+		for (int i = 0; i < kMaxDecodedBlocks; i++)
+			blocks[i].index = -1;
+	}
+
+	// Replace an unused or else the least recently used block
+	DecodedBlock *target = &blocks[0];
+	for (int i = 0; i < kMaxDecodedBlocks; i++) {
+		if (blocks[i].index == -1) {
+			target = &blocks[i];
+			break;
+		}
+		if (blocks[i].lastUsed < target->lastUsed)
+			target = &blocks[i];
+	}
+
+	target->index = index;
+	target->block = block;
+	target->size = size;
+	target->lastUsed = ++_blockUseCounter;
+	memcpy(target->data, data, size);
+}
+
 int BundleDirCache::matchFile(const char *filename) {
 	int32 tag, offset;
 	bool found = false;
@@ -149,6 +203,7 @@ BundleMgr::BundleMgr(BundleDirCache *cache) {
 	_fileBundleId = -1;
 	_file = new ScummFile();
 	_compInputBuff = NULL;
+	_slot = -1;
 }
 
 BundleMgr::~BundleMgr() {
@@ -184,13 +239,13 @@ bool BundleMgr::open(const char *filename, bool &compressed, bool errorFlag) {
 		return false;
 	}
 
-	int slot = _cache->matchFile(filename);
-	assert(slot != -1);
-	compressed = _cache->isSndDataExtComp(slot);
-	_numFiles = _cache->getNumFiles(slot);
+	_slot = _cache->matchFile(filename);
+	assert(_slot != -1);
+	compressed = _cache->isSndDataExtComp(_slot);
+	_numFiles = _cache->getNumFiles(_slot);
 	assert(_numFiles);
-	_bundleTable = _cache->getTable(slot);
-	_indexTable = _cache->getIndexTable(slot);
+	_bundleTable = _cache->getTable(_slot);
+	_indexTable = _cache->getIndexTable(_slot);
 	assert(_bundleTable);
 	_compTableLoaded = false;
 	_outputSize = 0;
@@ -288,13 +343,19 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 
 	for (i = firstBlock; i <= lastBlock; i++) {
 		if (_lastBlock != i) {
-			// CMI hack: one more zero byte at the end of input buffer
-			_compInputBuff[_compTable[i].size] = 0;
-			_file->seek(_bundleTable[index].offset + _compTable[i].offset, SEEK_SET);
-			_file->read(_compInputBuff, _compTable[i].size);
-			_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
-			if (_outputSize > 0x2000) {
-				error("_outputSize: %d", _outputSize);
+			const byte *cachedBlock = _cache->findDecodedBlock(_slot, index, i, _outputSize);
+			if (cachedBlock) {
+				memcpy(_compOutputBuff, cachedBlock, _outputSize);
+			} else {
+				// CMI hack: one more zero byte at the end of input buffer
+				_compInputBuff[_compTable[i].size] = 0;
+				_file->seek(_bundleTable[index].offset + _compTable[i].offset, SEEK_SET);
+				_file->read(_compInputBuff, _compTable[i].size);
+				_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
+				if (_outputSize > 0x2000) {
+					error("_outputSize: %d", _outputSize);
+				}
+				_cache->storeDecodedBlock(_slot, index, i, _compOutputBuff, _outputSize);
 			}
 			_lastBlock = i;
 		}
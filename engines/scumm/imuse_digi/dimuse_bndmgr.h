@@ -43,16 +43,37 @@ public:
 		int32 index;
 	};
 
+	struct DecodeStats {
+		uint32 blocksDecoded;	// number of COMP blocks decompressed
+		uint32 blockCacheHits;	// number of COMP blocks found in the cache
+	};
+
 private:
 
+	enum {
+		kMaxDecodedBlocks = 32	// decoded COMP blocks kept per bundle
+	};
+
+	struct DecodedBlock {
+		int32 index;			// bundle entry the block belongs to, -1 if unused
+		int32 block;
+		int32 size;
+		uint32 lastUsed;
+		byte data[0x2000];
+	};
+
 	struct FileDirCache {
 		char fileName[20];
 		AudioTable *bundleTable;
 		int32 numFiles;
 		bool isCompressed;
 		IndexNode *indexTable;
+		DecodedBlock *decodedBlocks;
 	} _budleDirCache[4];
 
+	uint32 _blockUseCounter;
+	DecodeStats _stats;
+
 public:
 	BundleDirCache();
 	~BundleDirCache();
@@ -62,6 +83,10 @@ public:
 	IndexNode *getIndexTable(int slot);
 	int32 getNumFiles(int slot);
 	bool isSndDataExtComp(int slot);
+
+	const byte *findDecodedBlock(int slot, int32 index, int32 block, int32 &size);
+	void storeDecodedBlock(int slot, int32 index, int32 block, const byte *data, int32 size);
+	const DecodeStats &getDecodeStats() const { return _stats; }
 };
 
 class BundleMgr {
@@ -85,6 +110,7 @@ private:
 	BaseScummFile *_file;
 	bool _compTableLoaded;
 	int _fileBundleId;
+	int _slot;
 	byte _compOutputBuff[0x2000];
 	byte *_compInputBuff;
 	int _outputSize;
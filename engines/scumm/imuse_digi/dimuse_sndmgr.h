@@ -134,6 +134,8 @@ public:
 	ImuseDigiSndMgr(ScummEngine *scumm);
 	~ImuseDigiSndMgr();
 
+	BundleDirCache *getBundleDirCache() { return _cacheBundleDir; }
+
 	SoundDesc *openSound(int32 soundId, const char *soundName, int soundType, int volGroupId, int disk);
 	void closeSound(SoundDesc *soundDesc);
 	SoundDesc *cloneSound(SoundDesc *soundDesc);
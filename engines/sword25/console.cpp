@@ -22,14 +22,221 @@
 
 #include "sword25/console.h"
 #include "sword25/sword25.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/kernel/inputpersistenceblock.h"
+#include "sword25/kernel/outputpersistenceblock.h"
+#include "sword25/kernel/persistenceservice.h"
+#include "sword25/kernel/resmanager.h"
+#include "sword25/kernel/resource.h"
+#include "sword25/script/script.h"
+#include "sword25/gfx/graphicengine.h"
+#include "sword25/input/inputengine.h"
+#include "sword25/math/regionregistry.h"
+#include "sword25/sfx/soundengine.h"
+#include "sword25/util/lua/lua.h"
+#include "sword25/gfx/bitmapresource.h"
+#include "sword25/gfx/image/vectorimage.h"
+
+#include "common/system.h"
 
 namespace Sword25 {
 
+namespace {
+
+/**
+ * Keeps track of the memory allocated by Lua, by wrapping its allocator.
+ */
+struct LuaAllocStats {
+	lua_Alloc alloc;
+	void *ud;
+	int32 used;
+	int32 peak;
+	uint32 count;
+
+	void reset() {
+		used = peak = 0;
+		count = 0;
+	}
+};
+
+void *countingLuaAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+	LuaAllocStats *stats = static_cast<LuaAllocStats *>(ud);
+	void *result = stats->alloc(stats->ud, ptr, osize, nsize);
+	if (result || nsize == 0) {
+		if (nsize > osize)
+			++stats->count;
+		stats->used += (int32)nsize - (int32)osize;
+		stats->peak = MAX(stats->peak, stats->used);
+	}
+	return result;
+}
+
+} // End of anonymous namespace
+
 Sword25Console::Sword25Console(Sword25Engine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	registerCmd("resources", WRAP_METHOD(Sword25Console, Cmd_Resources));
+	registerCmd("vector_benchmark", WRAP_METHOD(Sword25Console, Cmd_VectorBenchmark));
+	registerCmd("lua_benchmark", WRAP_METHOD(Sword25Console, Cmd_LuaBenchmark));
 }
 
 Sword25Console::~Sword25Console() {
 }
 
+bool Sword25Console::Cmd_Resources(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && Common::String(argv[1]) != "clear")) {
+		debugPrintf("Usage: %s [clear]\n", argv[0]);
+		return true;
+	}
+
+	ResourceManager *resourceManager = Kernel::getInstance()->getResourceManager();
+	if (argc == 2) {
+		resourceManager->emptyCache();
+		resourceManager->resetStats();
+		debugPrintf("Released all unlocked resources\n");
+		return true;
+	}
+
+	const uint32 lookups = resourceManager->getHits() + resourceManager->getMisses();
+	debugPrintf("Resources: %u (%u locked), using %u of %u KB\n", resourceManager->getResourceCount(),
+	            resourceManager->getLockedResourceCount(), resourceManager->getUsedMemory() / 1024, resourceManager->getMaxMemory() / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate), evictions: %u\n", resourceManager->getHits(), resourceManager->getMisses(),
+	            lookups ? resourceManager->getHits() * 100 / lookups : 0, resourceManager->getEvictions());
+	return true;
+}
+
+bool Sword25Console::Cmd_VectorBenchmark(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [iterations]\n", argv[0]);
+		return true;
+	}
+
+	const int iterations = (argc == 2) ? atoi(argv[1]) : 10;
+	if (iterations <= 0) {
+		debugPrintf("Invalid number of iterations\n");
+		return true;
+	}
+
+	// The vector images are the bitmap resources that were loaded from SWF files
+	Common::Array<VectorImage *> images;
+	const Common::List<Resource *> &resources = Kernel::getInstance()->getResourceManager()->getResources();
+	for (Common::List<Resource *>::const_iterator it = resources.begin(); it != resources.end(); ++it) {
+		if ((*it)->getType() == Resource::TYPE_BITMAP && (*it)->getFileName().hasSuffix(".swf"))
+			images.push_back(static_cast<VectorImage *>(static_cast<BitmapResource *>(*it)->getImage()));
+	}
+
+	if (images.empty()) {
+		debugPrintf("No vector images are loaded\n");
+		return true;
+	}
+
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (uint j = 0; j < images.size(); j++) {
+			images[j]->clearRasterCache();
+			images[j]->getRaster(images[j]->getWidth(), images[j]->getHeight());
+		}
+	}
+	const uint32 renderTime = g_system->getMillis() - start;
+
+	start = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (uint j = 0; j < images.size(); j++)
+			images[j]->getRaster(images[j]->getWidth(), images[j]->getHeight());
+	}
+	const uint32 cachedTime = g_system->getMillis() - start;
+
+	debugPrintf("Drew %u vector images %d times\n", images.size(), iterations);
+	debugPrintf("Rendered: %u ms (%u us per image), cached: %u ms\n", renderTime,
+	            (uint)((uint64)renderTime * 1000 / (images.size() * iterations)), cachedTime);
+	return true;
+}
+
+bool Sword25Console::Cmd_LuaBenchmark(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [iterations]\n", argv[0]);
+		return true;
+	}
+
+	const int iterations = (argc == 2) ? atoi(argv[1]) : 10;
+	if (iterations <= 0) {
+		debugPrintf("Invalid number of iterations\n");
+		return true;
+	}
+
+	Kernel *kernel = Kernel::getInstance();
+	ScriptEngine *script = kernel->getScript();
+	lua_State *L = static_cast<lua_State *>(script->getScriptObject());
+
+	// Static, so that Lua can never be left with a pointer into a stack frame that is gone
+	static LuaAllocStats stats;
+	stats.alloc = lua_getallocf(L, &stats.ud);
+	lua_setallocf(L, countingLuaAlloc, &stats);
+
+	uint32 persistTime = 0;
+	uint32 unpersistTime = 0;
+	int32 persistPeak = 0;
+	int32 unpersistPeak = 0;
+	uint32 persistCount = 0;
+	uint32 unpersistCount = 0;
+	uint dataSize = 0;
+
+	// Every iteration saves and restores the whole game state, in the same order as
+	// PersistenceService::saveGame() and loadGame(). Restoring the Lua state alone would
+	// leave its userdata pointing at regions and other objects that no longer exist.
+	bool persisted = true;
+	bool unpersisted = true;
+	for (int i = 0; i < iterations && persisted && unpersisted; i++) {
+		OutputPersistenceBlock writer;
+
+		stats.reset();
+		uint32 start = g_system->getMillis();
+		persisted &= script->persist(writer);
+		persistTime += g_system->getMillis() - start;
+		persistPeak = MAX(persistPeak, stats.peak);
+		persistCount += stats.count;
+		dataSize = writer.getDataSize();
+
+		persisted &= RegionRegistry::instance().persist(writer);
+		persisted &= kernel->getGfx()->persist(writer);
+		persisted &= kernel->getSfx()->persist(writer);
+		persisted &= kernel->getInput()->persist(writer);
+		if (!persisted)
+			break;
+
+		InputPersistenceBlock reader(writer.getData(), writer.getDataSize(), PersistenceService::getCurrentSavegameVersion());
+
+		stats.reset();
+		start = g_system->getMillis();
+		unpersisted &= script->unpersist(reader);
+		unpersistTime += g_system->getMillis() - start;
+		unpersistPeak = MAX(unpersistPeak, stats.peak);
+		unpersistCount += stats.count;
+
+		unpersisted &= RegionRegistry::instance().unpersist(reader);
+		unpersisted &= kernel->getGfx()->unpersist(reader);
+		unpersisted &= kernel->getSfx()->unpersist(reader);
+		unpersisted &= kernel->getInput()->unpersist(reader);
+	}
+
+	lua_setallocf(L, stats.alloc, stats.ud);
+
+	// Like a failed savegame load, this leaves the game in an undefined state
+	if (!unpersisted)
+		error("Unable to restore the game state saved by %s", argv[0]);
+
+	if (!persisted) {
+		debugPrintf("Unable to save the game state\n");
+		return true;
+	}
+
+	debugPrintf("Lua state: %u KB, %d iterations\n", dataSize / 1024, iterations);
+	debugPrintf("Persist: %u ms per iteration, %u allocations, peak %d KB allocated by Lua\n",
+	            persistTime / iterations, persistCount / iterations, persistPeak / 1024);
+	debugPrintf("Unpersist: %u ms per iteration, %u allocations, peak %d KB allocated by Lua\n",
+	            unpersistTime / iterations, unpersistCount / iterations, unpersistPeak / 1024);
+	return true;
+}
+
 } // End of namespace Sword25
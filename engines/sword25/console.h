@@ -36,6 +36,21 @@ public:
 
 private:
 	Sword25Engine *_vm;
+
+	/**
+	 * Shows the memory used by the loaded resources and the hit rate of the
+	 * resource cache, or releases the unlocked resources
+	 */
+	bool Cmd_Resources(int argc, const char **argv);
+	/**
+	 * Times rendering the loaded vector images, with and without the raster cache
+	 */
+	bool Cmd_VectorBenchmark(int argc, const char **argv);
+	/**
+	 * Times saving and restoring the current Lua state, as done for saved games,
+	 * and reports the memory Lua allocates meanwhile
+	 */
+	bool Cmd_LuaBenchmark(int argc, const char **argv);
 };
 
 } // End of namespace Sword25
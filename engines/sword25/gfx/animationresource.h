@@ -57,6 +57,9 @@ public:
 	virtual void unlock() {
 		release();
 	}
+	virtual uint getMemoryUsage() const {
+		return _frames.size() * sizeof(Frame);
+	}
 
 	Animation::ANIMATION_TYPES getAnimationType() const {
 		return _animationType;
@@ -44,6 +44,14 @@ public:
 					_pImage(pImage), Resource(filename, Resource::TYPE_BITMAP) {}
 	virtual ~BitmapResource() { delete _pImage; }
 
+	virtual uint getMemoryUsage() const {
+		return _pImage ? _pImage->getMemoryUsage() : 0;
+	}
+
+	Image *getImage() const {
+		return _pImage;
+	}
+
 	/**
 	    @brief Gibt zurck, ob das Objekt einen gltigen Zustand hat.
 	*/
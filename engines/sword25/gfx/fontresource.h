@@ -96,6 +96,10 @@ public:
 		return _bitmapFileName;
 	}
 
+	virtual uint getMemoryUsage() const {
+		return sizeof(_characterRects);
+	}
+
 private:
 	Kernel *_pKernel;
 	bool _valid;
@@ -71,6 +71,11 @@ public:
 	*/
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const = 0;
 
+	/**
+	    @brief Returns the number of bytes of memory used by the image data
+	*/
+	virtual uint getMemoryUsage() const = 0;
+
 	//@}
 
 	//@{
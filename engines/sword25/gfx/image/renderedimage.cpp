@@ -178,11 +178,20 @@ RenderedImage::RenderedImage() : _isTransparent(true) {
 // -----------------------------------------------------------------------------
 
 RenderedImage::~RenderedImage() {
+	invalidateTransformCache();
+
 	if (_doCleanup) {
 		_surface.free();
 	}
 }
 
+void RenderedImage::invalidateTransformCache() {
+	// The graphic engine may already be gone when the last images are freed
+	GraphicEngine *gfx = Kernel::getInstance()->getGfx();
+	if (gfx)
+		gfx->getTransformCache().invalidate(this);
+}
+
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::fill(const Common::Rect *pFillRect, uint color) {
@@ -199,6 +208,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 		return false;
 	}
 
+	invalidateTransformCache();
+
 	const byte *in = &pixeldata[offset];
 	byte *out = (byte *)_surface.getPixels();
 
@@ -212,6 +223,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 }
 
 void RenderedImage::replaceContent(byte *pixeldata, int width, int height) {
+	invalidateTransformCache();
+
 	_surface.w = width;
 	_surface.h = height;
 	_surface.pitch = width * 4;
@@ -227,7 +240,35 @@ uint RenderedImage::getPixel(int x, int y) {
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, RectangleList *updateRects) {
-	_surface.blit(*_backSurface, posX, posY, (((flipping & 1) ? Graphics::FLIP_V : 0) | ((flipping & 2) ? Graphics::FLIP_H : 0)), pPartRect, color, width, height);
+	const int flip = ((flipping & 1) ? Graphics::FLIP_V : 0) | ((flipping & 2) ? Graphics::FLIP_H : 0);
+
+	Common::Rect area(_surface.w, _surface.h);
+	if (pPartRect) {
+		// As in TransparentSurface::blit, the part rectangle refers to the
+		// unflipped image
+		area = *pPartRect;
+		if (flip & Graphics::FLIP_V)
+			area.moveTo(area.left, _surface.h - pPartRect->bottom);
+		if (flip & Graphics::FLIP_H)
+			area.moveTo(_surface.w - pPartRect->right, area.top);
+	}
+
+	if ((width == -1 || width == area.width()) && (height == -1 || height == area.height())) {
+		_surface.blit(*_backSurface, posX, posY, flip, pPartRect, color, width, height);
+		return true;
+	}
+
+	// Scaled images are usually drawn at the same size over many frames,
+	// so reuse the scaled copy from the previous frames when there is one
+	if (width == -1)
+		width = area.width();
+	if (height == -1)
+		height = area.height();
+
+	Graphics::TransparentSurface src(_surface.getSubArea(area), false);
+	Graphics::TransformedSurfaceCache::SurfacePtr scaled = Kernel::getInstance()->getGfx()->getTransformCache().scale(this, area, src, width, height);
+	Graphics::TransparentSurface scaledImage(*scaled, false);
+	scaledImage.blit(*_backSurface, posX, posY, flip, nullptr, color);
 
 	return true;
 }
@@ -69,6 +69,9 @@ public:
 	virtual int getHeight() const {
 		return _surface.h;
 	}
+	virtual uint getMemoryUsage() const {
+		return _surface.pitch * _surface.h;
+	}
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
@@ -119,6 +122,11 @@ private:
 	Graphics::Surface *_backSurface;
 
 	void checkForTransparency();
+
+	/**
+	 * Drops the scaled copies of this image from the transform cache.
+	 */
+	void invalidateTransformCache();
 };
 
 } // End of namespace Sword25
@@ -50,6 +50,9 @@ public:
 	virtual int getHeight() const {
 		return _image.h;
 	}
+	virtual uint getMemoryUsage() const {
+		return _image.pitch * _image.h;
+	}
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
@@ -215,7 +215,7 @@ Common::Rect CalculateBoundingBox(const VectorImageElement &vectorImageElement)
 // Construction
 // -----------------------------------------------------------------------------
 
-VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _fname(fname) {
+VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelDataSize(0), _fname(fname) {
 	success = false;
 	_bgColor = 0;
 
@@ -312,7 +312,7 @@ VectorImage::~VectorImage() {
 			if (_elements[j].getPathInfo(i).getVec())
 				free(_elements[j].getPathInfo(i).getVec());
 
-	free(_pixelData);
+	clearRasterCache();
 }
 
 
@@ -610,32 +610,70 @@ bool VectorImage::setContent(const byte *pixeldata, uint size, uint offset, uint
 	return 0;
 }
 
+uint VectorImage::getMemoryUsage() const {
+	uint size = _pixelDataSize;
+	for (uint e = 0; e < _elements.size(); e++) {
+		for (uint p = 0; p < _elements[e].getPathCount(); p++)
+			size += _elements[e].getPathInfo(p).getVecLen() * sizeof(ArtBpath);
+	}
+
+	return size;
+}
+
+byte *VectorImage::getRaster(int width, int height) {
+	for (Common::List<Raster>::iterator it = _rasters.begin(); it != _rasters.end(); ++it) {
+		if (it->width == width && it->height == height) {
+			Raster raster = *it;
+			if (it != _rasters.begin()) {
+				_rasters.erase(it);
+				_rasters.push_front(raster);
+			}
+			return raster.pixelData;
+		}
+	}
+
+	if (_rasters.size() >= kMaxCachedRasters) {
+		_pixelDataSize -= _rasters.back().width * _rasters.back().height * 4;
+		free(_rasters.back().pixelData);
+		_rasters.pop_back();
+	}
+
+	Raster raster;
+	raster.width = width;
+	raster.height = height;
+	raster.pixelData = render(width, height);
+	_rasters.push_front(raster);
+	_pixelDataSize += width * height * 4;
+
+	return raster.pixelData;
+}
+
+void VectorImage::clearRasterCache() {
+	for (Common::List<Raster>::iterator it = _rasters.begin(); it != _rasters.end(); ++it)
+		free(it->pixelData);
+	_rasters.clear();
+	_pixelDataSize = 0;
+}
+
 bool VectorImage::blit(int posX, int posY,
                        int flipping,
                        Common::Rect *pPartRect,
                        uint color,
                        int width, int height,
 					   RectangleList *updateRects) {
-	static VectorImage *oldThis = 0;
-	static int              oldWidth = -2;
-	static int              oldHeight = -2;
+	// -1 means the image is not scaled
+	if (width == -1)
+		width = getWidth();
+	if (height == -1)
+		height = getHeight();
 
 	// If width or height to 0, nothing needs to be shown.
 	if (width == 0 || height == 0)
 		return true;
 
-	// Determine if the old image in the cache can not be reused and must be recalculated
-	if (!(oldThis == this && oldWidth == width && oldHeight == height)) {
-		render(width, height);
-
-		oldThis = this;
-		oldHeight = height;
-		oldWidth = width;
-	}
-
 	RenderedImage *rend = new RenderedImage();
 
-	rend->replaceContent(_pixelData, width, height);
+	rend->replaceContent(getRaster(width, height), width, height);
 	rend->blit(posX, posY, flipping, pPartRect, color, width, height, updateRects);
 
 	delete rend;
@@ -38,6 +38,7 @@
 
 #include "sword25/kernel/common.h"
 #include "sword25/gfx/image/image.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 #include "art.h"
@@ -178,12 +179,24 @@ public:
 	virtual int getHeight() const {
 		return _boundingBox.height();
 	}
+	virtual uint getMemoryUsage() const;
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
 	virtual bool fill(const Common::Rect *pFillRect = 0, uint color = BS_RGB(0, 0, 0));
 
-	void render(int width, int height);
+	/**
+	    @brief Returns the image rasterized at the given size.
+
+	    The rasterized images are cached, so that images which are drawn every frame at
+	    the same size are only rendered once.
+	*/
+	byte *getRaster(int width, int height);
+
+	/**
+	    @brief Frees all the cached rasterized images.
+	*/
+	void clearRasterCache();
 
 	virtual uint getPixel(int x, int y);
 	virtual bool isBlitSource() const {
@@ -222,10 +235,25 @@ private:
 	bool parseStyles(uint shapeType, SWFBitStream &bs, uint &numFillBits, uint &numLineBits);
 
 	ArtBpath *storeBez(ArtBpath *bez, int lineStyle, int fillStyle0, int fillStyle1, int *bezNodes, int *bezAllocated);
+	byte *render(int width, int height);
+
 	Common::Array<VectorImageElement>    _elements;
 	Common::Rect                         _boundingBox;
 
-	byte *_pixelData;
+	/** An image rasterized at a given size */
+	struct Raster {
+		int width;
+		int height;
+		byte *pixelData;
+	};
+
+	enum {
+		kMaxCachedRasters = 4
+	};
+
+	/** The cached rasterized images, most recently used first */
+	Common::List<Raster> _rasters;
+	uint _pixelDataSize;
 
 	Common::String _fname;
 	uint _bgColor;
@@ -61,7 +61,7 @@ RenderObjectManager::RenderObjectManager(int width, int height, int framebufferC
 	_frameStarted(false) {
 	// Wurzel des BS_RenderObject-Baumes erzeugen.
 	_rootPtr = (new RootRenderObject(this, width, height))->getHandle();
-	_uta = new MicroTileArray(width, height);
+	_uta = new Graphics::MicroTileArray(width, height);
 	_currQueue = new RenderObjectQueue();
 	_prevQueue = new RenderObjectQueue();
 }
@@ -114,7 +114,8 @@ bool RenderObjectManager::render() {
 			_uta->addRect((*it)._bbox);
 	}
 
-	RectangleList *updateRects = _uta->getRectangles();
+	RectangleList *updateRects = new RectangleList();
+	_uta->getRectangles(*updateRects);
 	Common::Array<int> updateRectsMinZ;
 
 	updateRectsMinZ.reserve(updateRects->size());
@@ -42,13 +42,13 @@
 #ifndef SWORD25_RENDEROBJECTMANAGER_H
 #define SWORD25_RENDEROBJECTMANAGER_H
 
+#include "common/list.h"
 #include "common/rect.h"
+#include "graphics/microtiles.h"
 #include "sword25/kernel/common.h"
 #include "sword25/gfx/renderobjectptr.h"
 #include "sword25/kernel/persistable.h"
 
-#include "sword25/gfx/microtiles.h"
-
 namespace Sword25 {
 
 class Kernel;
@@ -56,6 +56,9 @@ class RenderObject;
 class TimedRenderObject;
 class RenderObjectManager;
 
+class RectangleList : public Common::List<Common::Rect> {
+};
+
 struct RenderObjectQueueItem {
 	RenderObject *_renderObject;
 	Common::Rect _bbox;
@@ -131,7 +134,7 @@ private:
 	typedef Common::Array<RenderObjectPtr<TimedRenderObject> > RenderObjectList;
 	RenderObjectList _timedRenderObjects;
 
-	MicroTileArray *_uta;
+	Graphics::MicroTileArray *_uta;
 	RenderObjectQueue *_currQueue, *_prevQueue;
 
 	// RenderObject-Tree Variablen
@@ -36,14 +36,15 @@
 namespace Sword25 {
 
 InputPersistenceBlock::InputPersistenceBlock(const void *data, uint dataLength, int version) :
-	_data(static_cast<const byte *>(data), dataLength),
+	_data(static_cast<const byte *>(data)),
+	_dataEnd(static_cast<const byte *>(data) + dataLength),
 	_errorState(NONE),
 	_version(version) {
-	_iter = _data.begin();
+	_iter = _data;
 }
 
 InputPersistenceBlock::~InputPersistenceBlock() {
-	if (_iter != _data.end())
+	if (_iter != _dataEnd)
 		warning("Persistence block was not read to the end.");
 }
 
@@ -118,8 +119,24 @@ void InputPersistenceBlock::readByteArray(Common::Array<byte> &value) {
 	}
 }
 
+void InputPersistenceBlock::readByteArray(const byte *&value, uint32 &size) {
+	value = 0;
+	size = 0;
+
+	if (checkMarker(BLOCK_MARKER)) {
+		uint32 blockSize;
+		read(blockSize);
+
+		if (checkBlockSize(blockSize)) {
+			value = _iter;
+			size = blockSize;
+			_iter += blockSize;
+		}
+	}
+}
+
 bool InputPersistenceBlock::checkBlockSize(int size) {
-	if (_data.end() - _iter >= size) {
+	if (_dataEnd - _iter >= size) {
 		return true;
 	} else {
 		_errorState = END_OF_DATA;
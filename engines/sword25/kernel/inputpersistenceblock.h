@@ -46,6 +46,10 @@ public:
 		OUT_OF_SYNC
 	};
 
+	/**
+	 * Creates a block reading the given data in place. The data must stay valid
+	 * for the lifetime of the block.
+	 */
 	InputPersistenceBlock(const void *data, uint dataLength, int version);
 	virtual ~InputPersistenceBlock();
 
@@ -56,6 +60,12 @@ public:
 	void read(bool &value);
 	void readString(Common::String &value);
 	void readByteArray(Common::Array<byte> &value);
+	/**
+	 * Reads a byte array without copying it.
+	 * @param value     Is set to point to the array within the block's data
+	 * @param size      Is set to the size of the array, or 0 on errors
+	 */
+	void readByteArray(const byte *&value, uint32 &size);
 
 	bool isGood() const {
 		return _errorState == NONE;
@@ -70,8 +80,9 @@ private:
 	bool checkMarker(byte marker);
 	bool checkBlockSize(int size);
 
-	Common::Array<byte> _data;
-	Common::Array<byte>::const_iterator _iter;
+	const byte *_data;
+	const byte *_dataEnd;
+	const byte *_iter;
 	ErrorState _errorState;
 
 	int _version;
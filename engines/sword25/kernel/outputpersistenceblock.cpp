@@ -92,6 +92,27 @@ void OutputPersistenceBlock::writeByteArray(Common::Array<byte> &value) {
 	rawWrite(&value[0], value.size());
 }
 
+OutputPersistenceBlock::BlockWriteStream::BlockWriteStream(OutputPersistenceBlock &block) : _block(block) {
+	// Same layout as write(const void *, uint32), with the size filled in at the end
+	_block.writeMarker(BLOCK_MARKER);
+	_block.write((uint32)0);
+	_sizeOffset = _block._data.size() - sizeof(uint32);
+	_dataOffset = _block._data.size();
+}
+
+OutputPersistenceBlock::BlockWriteStream::~BlockWriteStream() {
+	WRITE_LE_UINT32(&_block._data[_sizeOffset], pos());
+}
+
+uint32 OutputPersistenceBlock::BlockWriteStream::write(const void *dataPtr, uint32 dataSize) {
+	_block.rawWrite(dataPtr, dataSize);
+	return dataSize;
+}
+
+int32 OutputPersistenceBlock::BlockWriteStream::pos() const {
+	return _block._data.size() - _dataOffset;
+}
+
 void OutputPersistenceBlock::writeMarker(byte marker) {
 	_data.push_back(marker);
 }
@@ -32,6 +32,7 @@
 #ifndef SWORD25_OUTPUTPERSISTENCEBLOCK_H
 #define SWORD25_OUTPUTPERSISTENCEBLOCK_H
 
+#include "common/stream.h"
 #include "sword25/kernel/common.h"
 #include "sword25/kernel/persistenceblock.h"
 
@@ -39,8 +40,36 @@ namespace Sword25 {
 
 class OutputPersistenceBlock : public PersistenceBlock {
 public:
+	/**
+	 * Writes a data block straight into a persistence block, for data that is
+	 * produced by a stream writer. This saves building the data in a separate
+	 * buffer first. The block is finished when the stream is destroyed, and the
+	 * persistence block must not be written to in the meantime.
+	 */
+	class BlockWriteStream : public Common::WriteStream {
+	public:
+		BlockWriteStream(OutputPersistenceBlock &block);
+		~BlockWriteStream();
+
+		uint32 write(const void *dataPtr, uint32 dataSize);
+		int32 pos() const;
+
+	private:
+		OutputPersistenceBlock &_block;
+		uint _sizeOffset;
+		uint _dataOffset;
+	};
+
 	OutputPersistenceBlock();
 
+	/**
+	 * Makes room for the given total amount of data, so that writing up to that
+	 * amount doesn't need any further allocations.
+	 */
+	void reserve(uint size) {
+		_data.reserve(size);
+	}
+
 	void write(const void *data, uint32 size);
 	void write(int32 value);
 	void write(uint32 value);
@@ -57,6 +86,8 @@ public:
 	}
 
 private:
+	friend class BlockWriteStream;
+
 	void writeMarker(byte marker);
 	void rawWrite(const void *dataPtr, size_t size);
 
@@ -251,6 +251,10 @@ Common::String &PersistenceService::getSavegameFilename(uint slotID) {
 	return result;
 }
 
+int PersistenceService::getCurrentSavegameVersion() {
+	return VERSIONNUM;
+}
+
 int PersistenceService::getSavegameVersion(uint slotID) {
 	if (!checkslotID(slotID))
 		return -1;
@@ -373,13 +377,21 @@ bool PersistenceService::loadGame(uint slotID) {
 	}
 #endif
 
-	byte *compressedDataBuffer = new byte[curSavegameInfo.gamedataLength];
+	// Older saved games compressed the game data again. Newer ones store it
+	// uncompressed, so it is read straight into the buffer it is used from.
+	const bool isCompressed = curSavegameInfo.gamedataUncompressedLength > curSavegameInfo.gamedataLength;
+	byte *compressedDataBuffer = isCompressed ? new byte[curSavegameInfo.gamedataLength] : 0;
 	byte *uncompressedDataBuffer = new byte[curSavegameInfo.gamedataUncompressedLength];
 	Common::String filename = generateSavegameFilename(slotID);
 	file = sfm->openForLoading(filename);
 
+	// Both lengths come from the header, so never read more than the
+	// uncompressed buffer holds
 	file->seek(curSavegameInfo.gamedataOffset);
-	file->read(reinterpret_cast<char *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength);
+	if (isCompressed)
+		file->read(compressedDataBuffer, curSavegameInfo.gamedataLength);
+	else
+		file->read(uncompressedDataBuffer, MIN(curSavegameInfo.gamedataLength, curSavegameInfo.gamedataUncompressedLength));
 	if (file->err()) {
 		error("Unable to load the gamedata from the savegame file \"%s\".", filename.c_str());
 		delete[] compressedDataBuffer;
@@ -390,8 +402,7 @@ bool PersistenceService::loadGame(uint slotID) {
 	// Uncompress game data, if needed.
 	unsigned long uncompressedBufferSize = curSavegameInfo.gamedataUncompressedLength;
 
-	if (uncompressedBufferSize > curSavegameInfo.gamedataLength) {
-		// Older saved game, where the game data was compressed again.
+	if (isCompressed) {
 		if (!Common::uncompress(reinterpret_cast<byte *>(&uncompressedDataBuffer[0]), &uncompressedBufferSize,
 					   reinterpret_cast<byte *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength)) {
 			error("Unable to decompress the gamedata from savegame file \"%s\".", filename.c_str());
@@ -400,9 +411,6 @@ bool PersistenceService::loadGame(uint slotID) {
 			delete file;
 			return false;
 		}
-	} else {
-		// Newer saved game with uncompressed game data, copy it as-is.
-		memcpy(uncompressedDataBuffer, compressedDataBuffer, uncompressedBufferSize);
 	}
 
 	InputPersistenceBlock reader(&uncompressedDataBuffer[0], curSavegameInfo.gamedataUncompressedLength, curSavegameInfo.version);
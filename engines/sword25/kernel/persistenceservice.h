@@ -52,6 +52,7 @@ public:
 	// -----------------------------------------------------------------------------
 
 	static uint getSlotCount();
+	static int getCurrentSavegameVersion();
 	static Common::String getSavegameDirectory();
 
 	void            reloadSlots();
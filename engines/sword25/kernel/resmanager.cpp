@@ -35,18 +35,36 @@
 #include "sword25/kernel/resservice.h"
 #include "sword25/package/packagemanager.h"
 
+#include "common/config-manager.h"
+
 namespace Sword25 {
 
-// Sets the amount of resources that are simultaneously loaded.
-// This needs to be a relatively high number, as all the animation
-// frames in each scene are loaded as separate resources.
-// Also, George's walk states are all loaded here (150 files)
+// The default amount of memory, in KB, that loaded resources may use. All
+// the animation frames in each scene are loaded as separate resources, as
+// well as George's walk states (150 files), so this needs to be large enough
+// to hold a complete scene. It can be changed with the resource_cache_size
+// setting.
+#define SWORD25_RESOURCECACHE_SIZE (64 * 1024)
+// When the limit above is exceeded, the resource manager purges resources
+// until their memory usage falls below this percentage of the limit
+#define SWORD25_RESOURCECACHE_PURGE_PERCENT 80
+// Locked image resources are forcibly released once this many resources are
+// loaded, until only SWORD25_RESOURCECACHE_MIN are left. See the FIXME in
+// deleteResourcesIfNecessary().
 #define SWORD25_RESOURCECACHE_MIN 400
-// The maximum number of loaded resources. If more than these resources
-// are loaded, the resource manager will start purging resources till it
-// hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
 
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_usedMemory(0) {
+	int maxMemory = SWORD25_RESOURCECACHE_SIZE;
+	if (ConfMan.hasKey("resource_cache_size"))
+		maxMemory = MAX(ConfMan.getInt("resource_cache_size"), 0);
+	_maxMemory = maxMemory * 1024;
+
+	resetStats();
+}
+
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
 	emptyCache();
@@ -86,29 +104,40 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  * Deletes resources as necessary until the specified memory limit is not being exceeded.
  */
 void ResourceManager::deleteResourcesIfNecessary() {
-	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	// If enough memory is available and not too many resources are loaded, or none are loaded at all,
+	// then the function can immediately end
+	const bool tooMany = _resources.size() >= SWORD25_RESOURCECACHE_MAX;
+	if ((_usedMemory <= _maxMemory && !tooMany) || _resources.empty())
 		return;
 
-	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
+	// Keep deleting resources until the memory usage falls well below the set maximum limit, so
+	// that the next few loads don't immediately trigger another purge.
 	// The list is processed backwards in order to first release those resources that have been
-	// not been accessed for the longest
+	// not been accessed for the longest. Too many resources are purged down to the minimum count.
+	const uint32 purgeTarget = _maxMemory / 100 * SWORD25_RESOURCECACHE_PURGE_PERCENT;
 	Common::List<Resource *>::iterator iter = _resources.end();
 	do {
 		--iter;
 
 		// The resource may be released only if it isn't locked
-		if ((*iter)->getLockCount() == 0)
+		if ((*iter)->getLockCount() == 0) {
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+			++_evictions;
+		}
+	} while (iter != _resources.begin() && (_usedMemory > purgeTarget || (tooMany && _resources.size() >= SWORD25_RESOURCECACHE_MIN)));
 
-	// Are we still above the minimum? If yes, then start releasing locked resources
+	// Are there still too many resources? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	// The resource count is checked rather than the memory usage, as the resources a
+	// large scene really uses may exceed the memory limit on their own.
+	if (!tooMany || _resources.size() <= SWORD25_RESOURCECACHE_MIN) {
+		if (_usedMemory > _maxMemory)
+			debugC(kDebugResource, "Locked resources use %u KB, exceeding the limit of %u KB", _usedMemory / 1024, _maxMemory / 1024);
 		return;
+	}
 
 	iter = _resources.end();
 	do {
@@ -125,6 +154,7 @@ void ResourceManager::deleteResourcesIfNecessary() {
 				(*iter)->release();
 
 			iter = deleteResource(*iter);
+			++_evictions;
 		}
 	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
 }
@@ -172,9 +202,14 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	// Determine whether the resource is already loaded
 	// If the resource is found, it will be placed at the head of the resource list and returned
 	Resource *pResource = getResource(uniqueFileName);
-	if (!pResource)
+	if (pResource) {
+		++_hits;
+	} else {
+		++_misses;
 		pResource = loadResource(uniqueFileName);
+	}
 	if (pResource) {
+		updateMemoryUsage(pResource);
 		moveToFront(pResource);
 		(pResource)->addReference();
 		return pResource;
@@ -233,6 +268,12 @@ void ResourceManager::moveToFront(Resource *pResource) {
 	pResource->_iterator = _resources.begin();
 }
 
+void ResourceManager::updateMemoryUsage(Resource *pResource) {
+	uint memoryUsage = pResource->getMemoryUsage();
+	_usedMemory = _usedMemory - pResource->_memoryUsage + memoryUsage;
+	pResource->_memoryUsage = memoryUsage;
+}
+
 /**
  * Loads a resource and updates the m_UsedMemory total
  *
@@ -260,6 +301,8 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
+			updateMemoryUsage(pResource);
+
 			return pResource;
 		}
 	}
@@ -296,6 +339,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	_usedMemory -= pResource->_memoryUsage;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -320,6 +365,22 @@ Resource *ResourceManager::getResource(const Common::String &uniquefileName) con
 	return NULL;
 }
 
+uint ResourceManager::getLockedResourceCount() const {
+	uint count = 0;
+	for (Common::List<Resource *>::const_iterator iter = _resources.begin(); iter != _resources.end(); ++iter) {
+		if ((*iter)->getLockCount() > 0)
+			++count;
+	}
+
+	return count;
+}
+
+void ResourceManager::resetStats() {
+	_hits = 0;
+	_misses = 0;
+	_evictions = 0;
+}
+
 /**
  * Writes the names of all currently locked resources to the log file
  */
@@ -88,16 +88,31 @@ public:
 	 */
 	void dumpLockedResources();
 
+	const Common::List<Resource *> &getResources() const { return _resources; }
+	uint getResourceCount() const { return _resources.size(); }
+	uint getLockedResourceCount() const;
+	uint32 getUsedMemory() const { return _usedMemory; }
+	uint32 getMaxMemory() const { return _maxMemory; }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getEvictions() const { return _evictions; }
+	void resetStats();
+
 private:
 	/**
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
+	/**
+	 * Updates the memory usage accounted for a resource, as e.g. vector images
+	 * grow when they are rendered at a new size.
+	 * @param pResource     The resource
+	 */
+	void updateMemoryUsage(Resource *pResource);
+
 	/**
 	 * Moves a resource to the top of the resource list
 	 * @param pResource     The resource
@@ -105,7 +120,7 @@ private:
 	void moveToFront(Resource *pResource);
 
 	/**
-	 * Loads a resource and updates the m_UsedMemory total
+	 * Loads a resource and updates the _usedMemory total
 	 *
 	 * The resource must not already be loaded
 	 * @param FileName      The unique filename of the resource to be loaded
@@ -119,7 +134,7 @@ private:
 	Common::String getUniqueFileName(const Common::String &fileName) const;
 
 	/**
-	 * Deletes a resource, removes it from the lists, and updates m_UsedMemory
+	 * Deletes a resource, removes it from the lists, and updates _usedMemory
 	 */
 	Common::List<Resource *>::iterator deleteResource(Resource *pResource);
 
@@ -139,6 +154,12 @@ private:
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+
+	uint32 _usedMemory;
+	uint32 _maxMemory;
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
 };
 
 } // End of namespace Sword25
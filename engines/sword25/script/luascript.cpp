@@ -50,6 +50,7 @@ namespace Sword25 {
 LuaScriptEngine::LuaScriptEngine(Kernel *KernelPtr) :
 	ScriptEngine(KernelPtr),
 	_state(0),
+	_lastPersistSize(0),
 	_pcallErrorhandlerRegistryIndex(0) {
 }
 
@@ -394,12 +395,14 @@ bool LuaScriptEngine::persist(OutputPersistenceBlock &writer) {
 	pushPermanentsTable(_state, PTT_PERSIST);
 	lua_getglobal(_state, "_G");
 
-	// Lua persists and stores the data in a WriteStream
-	Common::MemoryWriteStreamDynamic writeStream;
-	Lua::persistLua(_state, &writeStream);
-
-	// Persistenzdaten in den Writer schreiben.
-	writer.write(writeStream.getData(), writeStream.size());
+	// Lua persists its data straight into the writer. Room for as much data as the
+	// last time is reserved up front, so that the writer rarely has to grow.
+	writer.reserve(writer.getDataSize() + _lastPersistSize);
+	{
+		OutputPersistenceBlock::BlockWriteStream writeStream(writer);
+		Lua::persistLua(_state, &writeStream);
+		_lastPersistSize = writeStream.pos();
+	}
 
 	// Die beiden Tabellen vom Stack nehmen.
 	lua_pop(_state, 2);
@@ -477,10 +480,13 @@ bool LuaScriptEngine::unpersist(InputPersistenceBlock &reader) {
 	};
 	clearGlobalTable(_state, clearExceptionsSecondPass);
 
-	// Persisted Lua data
-	Common::Array<byte> chunkData;
-	reader.readByteArray(chunkData);
-	Common::MemoryReadStream readStream(&chunkData[0], chunkData.size(), DisposeAfterUse::NO);
+	// Persisted Lua data, read in place
+	const byte *chunkData;
+	uint32 chunkSize;
+	reader.readByteArray(chunkData, chunkSize);
+	if (!chunkData)
+		return false;
+	Common::MemoryReadStream readStream(chunkData, chunkSize, DisposeAfterUse::NO);
 
 	Lua::unpersistLua(_state, &readStream);
 
@@ -95,6 +95,8 @@ public:
 
 private:
 	lua_State *_state;
+	/** The size of the Lua data written by the last persist() call */
+	uint _lastPersistSize;
 	int _pcallErrorhandlerRegistryIndex;
 
 	bool registerStandardLibs();
@@ -29,7 +29,8 @@ void CJPEGDecode::decode(OSVideoSurface &surface, const CString &name) {
 	StdCWadFile file;
 	file.open(name);
 
-	// Use the ScucmmVM deoder to decode it
+	// Use the ScummVM decoder to decode it, straight into the format of our surfaces
+	setOutputPixelFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
 	loadStream(*file.readStream());
 	const Graphics::Surface *srcSurf = getSurface();
 	
@@ -38,15 +39,21 @@ void CJPEGDecode::decode(OSVideoSurface &surface, const CString &name) {
 			|| surface.getHeight() != srcSurf->h)
 		surface.recreate(srcSurf->w, srcSurf->h);
 
-	// Convert the decoded surface to the correct pixel format, and then copy it over
+	// Copy the decoded surface over, converting it in the unlikely case it
+	// does not match the format of the video surface
 	surface.lock();
-	Graphics::Surface *convertedSurface = srcSurf->convertTo(surface._rawSurface->format);
+	if (srcSurf->format == surface._rawSurface->format) {
+		Common::copy((const byte *)srcSurf->getPixels(), (const byte *)srcSurf->getPixels() +
+			surface.getPitch() * surface.getHeight(), (byte *)surface._rawSurface->getPixels());
+	} else {
+		Graphics::Surface *convertedSurface = srcSurf->convertTo(surface._rawSurface->format);
 
-	Common::copy((byte *)convertedSurface->getPixels(), (byte *)convertedSurface->getPixels() +
-		surface.getPitch() * surface.getHeight(), (byte *)surface._rawSurface->getPixels());
+		Common::copy((byte *)convertedSurface->getPixels(), (byte *)convertedSurface->getPixels() +
+			surface.getPitch() * surface.getHeight(), (byte *)surface._rawSurface->getPixels());
 
-	convertedSurface->free();
-	delete convertedSurface;
+		convertedSurface->free();
+		delete convertedSurface;
+	}
 	surface.unlock();
 }
 
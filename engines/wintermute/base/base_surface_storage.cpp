@@ -34,6 +34,7 @@
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/platform_osystem.h"
 #include "common/str.h"
+#include "common/system.h"
 
 namespace Wintermute {
 
@@ -42,6 +43,12 @@ namespace Wintermute {
 //////////////////////////////////////////////////////////////////////
 BaseSurfaceStorage::BaseSurfaceStorage(BaseGame *inGame) : BaseClass(inGame) {
 	_lastCleanupTime = 0;
+	_preloading = false;
+	_preloadCount = 0;
+	_preloadTime = 0;
+	_blockingLoadCount = 0;
+	_blockingLoadTime = 0;
+	_maxBlockingLoadTime = 0;
 }
 
 
@@ -60,6 +67,8 @@ bool BaseSurfaceStorage::cleanup(bool warn) {
 		delete _surfaces[i];
 	}
 	_surfaces.clear();
+	_surfaceIndex.clear();
+	_preloadQueue.clear();
 
 	return STATUS_OK;
 }
@@ -67,6 +76,8 @@ bool BaseSurfaceStorage::cleanup(bool warn) {
 
 //////////////////////////////////////////////////////////////////////////
 bool BaseSurfaceStorage::initLoop() {
+	preloadSurfaces();
+
 	if (_gameRef->_smartCache && _gameRef->getLiveTimer()->getTime() - _lastCleanupTime >= _gameRef->_surfaceGCCycleTime) {
 		_lastCleanupTime = _gameRef->getLiveTimer()->getTime();
 		sortSurfaces();
@@ -91,6 +102,8 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 		if (_surfaces[i] == surface) {
 			_surfaces[i]->_referenceCount--;
 			if (_surfaces[i]->_referenceCount <= 0) {
+				_surfaceIndex.erase(_surfaces[i]->getFileNameStr());
+				_preloadQueue.remove(_surfaces[i]);
 				delete _surfaces[i];
 				_surfaces.remove_at(i);
 			}
@@ -103,11 +116,10 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 
 //////////////////////////////////////////////////////////////////////
 BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime, bool keepLoaded) {
-	for (uint32 i = 0; i < _surfaces.size(); i++) {
-		if (scumm_stricmp(_surfaces[i]->getFileName(), filename.c_str()) == 0) {
-			_surfaces[i]->_referenceCount++;
-			return _surfaces[i];
-		}
+	SurfaceMap::iterator it = _surfaceIndex.find(filename);
+	if (it != _surfaceIndex.end()) {
+		it->_value->_referenceCount++;
+		return it->_value;
 	}
 
 	if (!BaseFileManager::getEngineInstance()->hasFile(filename)) {
@@ -134,11 +146,50 @@ BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool
 	} else {
 		surface->_referenceCount = 1;
 		_surfaces.push_back(surface);
+		_surfaceIndex[surface->getFileNameStr()] = surface;
+		if (surface->isLoadPending()) {
+			_preloadQueue.push_back(surface);
+		}
 		return surface;
 	}
 }
 
 
+//////////////////////////////////////////////////////////////////////
+void BaseSurfaceStorage::preloadSurfaces() {
+	const uint32 startTime = g_system->getMillis();
+
+	_preloading = true;
+	while (!_preloadQueue.empty() && g_system->getMillis() - startTime < kPreloadTimePerFrame) {
+		BaseSurface *surface = _preloadQueue.front();
+		_preloadQueue.pop_front();
+		if (surface->isLoadPending()) {
+			surface->finishLoad();
+		}
+	}
+	_preloading = false;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+void BaseSurfaceStorage::surfaceLoaded(BaseSurface *surface, uint32 decodeTime) {
+	if (_preloading) {
+		// Count the surface as used now, otherwise the cache cleanup would
+		// drop it again before it is ever drawn
+		surface->_lastUsedTime = _gameRef->getLiveTimer()->getTime();
+		_preloadCount++;
+		_preloadTime += decodeTime;
+		return;
+	}
+
+	// The surface was needed before its turn in the queue came
+	_preloadQueue.remove(surface);
+	_blockingLoadCount++;
+	_blockingLoadTime += decodeTime;
+	_maxBlockingLoadTime = MAX(_maxBlockingLoadTime, decodeTime);
+}
+
+
 //////////////////////////////////////////////////////////////////////
 bool BaseSurfaceStorage::restoreAll() {
 	bool ret;
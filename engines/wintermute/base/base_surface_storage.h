@@ -31,6 +31,9 @@
 
 #include "engines/wintermute/base/base.h"
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 
 namespace Wintermute {
 class BaseSurface;
@@ -49,7 +52,48 @@ public:
 	BaseSurfaceStorage(BaseGame *inGame);
 	virtual ~BaseSurfaceStorage();
 
+	/**
+	 * Decodes queued images until the per-frame time budget is used up.
+	 * Surfaces are queued when they are added, so that by the time they
+	 * are first drawn their image is usually ready.
+	 */
+	void preloadSurfaces();
+
+	/**
+	 * Called by the surfaces once their image has been decoded.
+	 * @param decodeTime	the time the decoding took, in ms
+	 */
+	void surfaceLoaded(BaseSurface *surface, uint32 decodeTime);
+
+	uint getPreloadQueueSize() const { return _preloadQueue.size(); }
+	uint32 getPreloadCount() const { return _preloadCount; }
+	uint32 getPreloadTime() const { return _preloadTime; }
+	uint32 getBlockingLoadCount() const { return _blockingLoadCount; }
+	uint32 getBlockingLoadTime() const { return _blockingLoadTime; }
+	uint32 getMaxBlockingLoadTime() const { return _maxBlockingLoadTime; }
+
 	Common::Array<BaseSurface *> _surfaces;
+
+private:
+	enum {
+		/** Time spent decoding queued images each frame, in ms */
+		kPreloadTimePerFrame = 4
+	};
+
+	typedef Common::HashMap<Common::String, BaseSurface *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SurfaceMap;
+
+	/** The surfaces of _surfaces, indexed by their file name */
+	SurfaceMap _surfaceIndex;
+
+	/** Surfaces whose image has not been decoded yet, oldest first */
+	Common::List<BaseSurface *> _preloadQueue;
+	bool _preloading;
+
+	uint32 _preloadCount;
+	uint32 _preloadTime;
+	uint32 _blockingLoadCount;
+	uint32 _blockingLoadTime;
+	uint32 _maxBlockingLoadTime;
 };
 
 } // End of namespace Wintermute
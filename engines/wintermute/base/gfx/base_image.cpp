@@ -47,6 +47,7 @@ BaseImage::BaseImage() {
 	_surface = nullptr;
 	_decoder = nullptr;
 	_deletableSurface = nullptr;
+	_hasAlpha = false;
 }
 
 
@@ -60,16 +61,27 @@ BaseImage::~BaseImage() {
 }
 
 bool BaseImage::loadFile(const Common::String &filename) {
+	Image::PNGDecoder *pngDecoder = nullptr;
+	bool isJPEG = false;
 	_filename = filename;
 	_filename.toLowercase();
 	if (filename.hasPrefix("savegame:") || _filename.hasSuffix(".bmp")) {
 		_decoder = new Image::BitmapDecoder();
 	} else if (_filename.hasSuffix(".png")) {
-		_decoder = new Image::PNGDecoder();
+		pngDecoder = new Image::PNGDecoder();
+		if (_outputPixelFormat.bytesPerPixel) {
+			pngDecoder->setOutputPixelFormat(_outputPixelFormat);
+		}
+		_decoder = pngDecoder;
 	} else if (_filename.hasSuffix(".tga")) {
 		_decoder = new Image::TGADecoder();
 	} else if (_filename.hasSuffix(".jpg")) {
-		_decoder = new Image::JPEGDecoder();
+		Image::JPEGDecoder *jpegDecoder = new Image::JPEGDecoder();
+		if (_outputPixelFormat.bytesPerPixel) {
+			jpegDecoder->setOutputPixelFormat(_outputPixelFormat);
+		}
+		_decoder = jpegDecoder;
+		isJPEG = true;
 	} else {
 		error("BaseImage::loadFile : Unsupported fileformat %s", filename.c_str());
 	}
@@ -82,6 +94,15 @@ bool BaseImage::loadFile(const Common::String &filename) {
 	_decoder->loadStream(*file);
 	_surface = _decoder->getSurface();
 	_palette = _decoder->getPalette();
+
+	// JPEG images are opaque, PNG images remember whether they had an alpha channel
+	if (pngDecoder) {
+		_hasAlpha = pngDecoder->hasAlpha();
+	} else if (isJPEG) {
+		_hasAlpha = false;
+	} else {
+		_hasAlpha = _surface->format.aBits() != 0;
+	}
 	_fileManager->closeFile(file);
 
 	return true;
@@ -48,7 +48,21 @@ public:
 	BaseImage();
 	~BaseImage();
 
+	/**
+	 * Requests the pixel format PNG and JPEG images are decoded to,
+	 * instead of their native one. Call before loadFile().
+	 */
+	void setOutputPixelFormat(const Graphics::PixelFormat &format) {
+		_outputPixelFormat = format;
+	}
 	bool loadFile(const Common::String &filename);
+	/**
+	 * Returns whether the loaded image has an alpha channel, whatever
+	 * format it was decoded to.
+	 */
+	bool hasAlpha() const {
+		return _hasAlpha;
+	}
 	const Graphics::Surface *getSurface() const {
 		return _surface;
 	};
@@ -67,6 +81,8 @@ private:
 	const Graphics::Surface *_surface;
 	Graphics::Surface *_deletableSurface;
 	const byte *_palette;
+	Graphics::PixelFormat _outputPixelFormat;
+	bool _hasAlpha;
 	BaseFileManager *_fileManager;
 };
 
@@ -30,10 +30,12 @@
 #define WINTERMUTE_BASE_RENDERER_SDL_H
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
 #include "graphics/transform_struct.h"
+#include "graphics/transformed_surface_cache.h"
 
 namespace Wintermute {
 class BaseSurfaceOSystem;
@@ -112,6 +114,10 @@ public:
 	void endSaveLoad();
 	void drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
 	BaseSurface *createSurface() override;
+	/**
+	 * The scaled and rotated copies of the surfaces drawn by the render tickets.
+	 */
+	Graphics::TransformedSurfaceCache &getTransformCache() { return _transformCache; }
 private:
 	/**
 	 * Mark a specified rect of the screen as dirty.
@@ -126,8 +132,9 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	DirtyRectContainer _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
+	Graphics::TransformedSurfaceCache _transformCache;
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
@@ -28,6 +28,7 @@
 
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/base_surface_storage.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
 #include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "engines/wintermute/base/gfx/base_image.h"
@@ -131,7 +132,10 @@ bool BaseSurfaceOSystem::create(const Common::String &filename, bool defaultCK,
 }
 
 bool BaseSurfaceOSystem::finishLoad() {
+	const uint32 startTime = g_system->getMillis();
+
 	BaseImage *image = new BaseImage();
+	image->setOutputPixelFormat(g_system->getScreenFormat());
 	if (!image->loadFile(_filename)) {
 		delete image;
 		return false;
@@ -169,7 +173,7 @@ bool BaseSurfaceOSystem::finishLoad() {
 			// 32 bpp BMPs have nothing useful in their alpha-channel -> color-key
 			needsColorKey = true;
 			replaceAlpha = false;
-		} else if (image->getSurface()->format.aBits() == 0) {
+		} else if (!image->hasAlpha()) {
 			needsColorKey = true;
 		}
 	}
@@ -188,6 +192,10 @@ bool BaseSurfaceOSystem::finishLoad() {
 
 	_loaded = true;
 
+	if (_gameRef->_surfaceStorage) {
+		_gameRef->_surfaceStorage->surfaceLoaded(this, g_system->getMillis() - startTime);
+	}
+
 	return true;
 }
 
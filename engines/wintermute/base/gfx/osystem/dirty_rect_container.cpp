@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+
+namespace Wintermute {
+
+DirtyRectContainer::DirtyRectContainer() {
+}
+
+void DirtyRectContainer::addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect) {
+	Common::Rect clipped(rect);
+	clipped.clip(clipRect);
+	if (clipped.isEmpty())
+		return;
+
+	if (_rects.size() >= kMaxRects) {
+		// Too many small changes, fall back to the bounding rect
+		Common::Rect bounds(_rects[0]);
+		for (uint i = 1; i < _rects.size(); i++)
+			bounds.extend(_rects[i]);
+		_rects.clear();
+		_rects.push_back(bounds);
+	}
+
+	for (uint i = 0; i < _rects.size(); i++) {
+		if (_rects[i].contains(clipped))
+			return;
+	}
+
+	for (uint i = 0; i < _rects.size();) {
+		if (clipped.contains(_rects[i]))
+			_rects.remove_at(i);
+		else
+			i++;
+	}
+
+	_rects.push_back(clipped);
+}
+
+void DirtyRectContainer::reset() {
+	_rects.clear();
+}
+
+bool DirtyRectContainer::shouldMerge(const Common::Rect &a, const Common::Rect &b) {
+	Common::Rect merged(a);
+	merged.extend(b);
+
+	int separateArea = getArea(a) + getArea(b);
+	if (a.intersects(b)) {
+		Common::Rect overlap(a);
+		overlap.clip(b);
+		separateArea -= getArea(overlap);
+	}
+
+	return getArea(merged) <= separateArea + kRectCost;
+}
+
+Common::Array<Common::Rect> DirtyRectContainer::getOptimized() const {
+	Common::Array<Common::Rect> rects(_rects);
+
+	// Merge pairs of rects until no merge pays off anymore
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (uint i = 0; i < rects.size(); i++) {
+			for (uint j = i + 1; j < rects.size();) {
+				if (shouldMerge(rects[i], rects[j])) {
+					rects[i].extend(rects[j]);
+					rects.remove_at(j);
+					merged = true;
+				} else {
+					j++;
+				}
+			}
+		}
+	}
+
+	return rects;
+}
+
+} // End of namespace Wintermute
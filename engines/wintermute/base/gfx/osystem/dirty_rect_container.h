@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_DIRTY_RECT_CONTAINER_H
+#define WINTERMUTE_DIRTY_RECT_CONTAINER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+/**
+ * The set of screen regions that have to be redrawn in the next frame.
+ *
+ * Instead of growing a single bounding rect, every dirty rect is kept, so
+ * that two small animations in opposite corners of the screen don't cause
+ * the whole screen in between to be redrawn. Before drawing, rects that
+ * are close to each other are merged, as every rect has a fixed cost of
+ * going through the render queue once.
+ */
+class DirtyRectContainer {
+public:
+	DirtyRectContainer();
+
+	/**
+	 * Add a rect to the dirty region.
+	 * @param rect the rect to add
+	 * @param clipRect the rect is clipped to this one (i.e. the screen)
+	 */
+	void addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect);
+
+	/**
+	 * Empty the dirty region.
+	 */
+	void reset();
+
+	bool isEmpty() const { return _rects.empty(); }
+
+	/**
+	 * Get the dirty region as a small set of rects, with nearby rects
+	 * merged. The rects may still overlap.
+	 */
+	Common::Array<Common::Rect> getOptimized() const;
+
+private:
+	enum {
+		/** Beyond this number of rects, only the bounding rect is kept */
+		kMaxRects = 128,
+		/** Cost of an additional rect, in pixels */
+		kRectCost = 64 * 64
+	};
+
+	static int getArea(const Common::Rect &rect) { return rect.width() * rect.height(); }
+	static bool shouldMerge(const Common::Rect &a, const Common::Rect &b);
+
+	Common::Array<Common::Rect> _rects;
+};
+
+} // End of namespace Wintermute
+
+#endif
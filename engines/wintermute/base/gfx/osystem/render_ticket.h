@@ -30,6 +30,7 @@
 #define WINTERMUTE_RENDER_TICKET_H
 
 #include "graphics/transparent_surface.h"
+#include "graphics/transformed_surface_cache.h"
 #include "graphics/surface.h"
 #include "common/rect.h"
 
@@ -51,7 +52,7 @@ class BaseSurfaceOSystem;
  */
 class RenderTicket {
 public:
-	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
+	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform, Graphics::TransformedSurfaceCache *transformCache = nullptr);
 	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
 	~RenderTicket();
 	const Graphics::Surface *getSurface() const { return _surface; }
@@ -72,6 +73,8 @@ public:
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
 private:
 	Graphics::Surface *_surface;
+	/** Holds _surface when it is shared with the transform cache */
+	Graphics::TransformedSurfaceCache::SurfacePtr _sharedSurface;
 	Common::Rect _srcRect;
 };
 
@@ -34,6 +34,7 @@
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/persistent.h"
+#include "common/ptr.h"
 
 namespace Wintermute {
 class BaseScriptHolder;
@@ -42,6 +43,18 @@ class ScEngine;
 class ScStack;
 class ScValue;
 
+struct ScriptBufferDeleter {
+	void operator()(byte *buffer) {
+		delete[] buffer;
+	}
+};
+
+/**
+ * Compiled script bytecode. It is never modified once loaded, so the
+ * script cache and all the scripts running the same file share one buffer.
+ */
+typedef Common::SharedPtr<byte> ScriptBuffer;
+
 class ScScript : public BaseClass {
 public:
 	BaseArray<int> _breakpoints;
@@ -133,12 +146,12 @@ public:
 	uint32 getDWORD();
 	double getFloat();
 	void cleanup();
-	bool create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner);
+	bool create(const char *filename, const ScriptBuffer &buffer, uint32 size, BaseScriptHolder *owner);
 	uint32 _iP;
 private:
 	void readHeader();
 	uint32 _bufferSize;
-	byte *_buffer;
+	ScriptBuffer _buffer;
 public:
 	Common::SeekableReadStream *_scriptStream;
 	ScScript(BaseGame *inGame, ScEngine *engine);
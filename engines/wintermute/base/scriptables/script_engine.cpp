@@ -34,6 +34,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/utils/utils.h"
+#include "common/config-manager.h"
 
 namespace Wintermute {
 
@@ -68,9 +69,13 @@ ScEngine::ScEngine(BaseGame *inGame) : BaseClass(inGame) {
 	}
 
 	// prepare script cache
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		_cachedScripts[i] = nullptr;
+	_scriptCacheHead = _scriptCacheTail = nullptr;
+	_scriptCacheBytes = 0;
+	_scriptCacheMaxBytes = kDefaultScriptCacheSize;
+	if (ConfMan.hasKey("script_cache_size")) {
+		_scriptCacheMaxBytes = MAX(ConfMan.getInt("script_cache_size"), 0) * 1024;
 	}
+	resetScriptCacheStats();
 
 	_currentScript = nullptr;
 
@@ -134,11 +139,10 @@ void ScEngine::parseElement(void *data, int line, int type, void *elementData) {
 
 //////////////////////////////////////////////////////////////////////////
 ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
-	byte *compBuffer;
 	uint32 compSize;
 
 	// get script from cache
-	compBuffer = getCompiledScript(filename, &compSize);
+	ScriptBuffer compBuffer = getCompiledScript(filename, &compSize);
 	if (!compBuffer) {
 		return nullptr;
 	}
@@ -178,76 +182,112 @@ ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
 
 
 //////////////////////////////////////////////////////////////////////////
-byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache) {
+ScriptBuffer ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache) {
 	// is script in cache?
-	if (!ignoreCache) {
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] && scumm_stricmp(_cachedScripts[i]->_filename.c_str(), filename) == 0) {
-				_cachedScripts[i]->_timestamp = g_system->getMillis();
-				*outSize = _cachedScripts[i]->_size;
-				return _cachedScripts[i]->_buffer;
-			}
+	ScriptCache::iterator it = _scriptCache.find(filename);
+	if (it != _scriptCache.end()) {
+		CachedScript *cachedScript = it->_value;
+		if (!ignoreCache) {
+			_scriptCacheHits++;
+			detachFromScriptCache(cachedScript);
+			addToScriptCache(cachedScript);
+			*outSize = cachedScript->_size;
+			return cachedScript->_buffer;
 		}
+		removeFromScriptCache(cachedScript);
 	}
 
 	// nope, load it
-	byte *compBuffer;
-	uint32 compSize;
+	_scriptCacheMisses++;
 
 	uint32 size;
 
 	byte *buffer = BaseEngine::instance().getFileManager()->readWholeFile(filename, &size);
 	if (!buffer) {
 		_gameRef->LOG(0, "ScEngine::GetCompiledScript - error opening script '%s'", filename);
-		return nullptr;
+		return ScriptBuffer();
 	}
 
 	// needs to be compiled?
-	if (FROM_LE_32(*(uint32 *)buffer) == SCRIPT_MAGIC) {
-		compBuffer = buffer;
-		compSize = size;
-	} else {
+	if (FROM_LE_32(*(uint32 *)buffer) != SCRIPT_MAGIC) {
 		if (!_compilerAvailable) {
 			_gameRef->LOG(0, "ScEngine::GetCompiledScript - script '%s' needs to be compiled but compiler is not available", filename);
 			delete[] buffer;
-			return nullptr;
+			return ScriptBuffer();
 		}
 		// This code will never be called, since _compilerAvailable is const false.
 		// It's only here in the event someone would want to reinclude the compiler.
 		error("Script needs compilation, ScummVM does not contain a WME compiler");
 	}
 
-	byte *ret = nullptr;
-
-	// add script to cache
-	CScCachedScript *cachedScript = new CScCachedScript(filename, compBuffer, compSize);
-	if (cachedScript) {
-		int index = 0;
-		uint32 minTime = g_system->getMillis();
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] == nullptr) {
-				index = i;
-				break;
-			} else if (_cachedScripts[i]->_timestamp <= minTime) {
-				minTime = _cachedScripts[i]->_timestamp;
-				index = i;
-			}
-		}
+	// the scripts share the loaded buffer with the cache, no need to copy it
+	ScriptBuffer compBuffer(buffer, ScriptBufferDeleter());
+	*outSize = size;
 
-		if (_cachedScripts[index] != nullptr) {
-			delete _cachedScripts[index];
+	// add script to cache, unless it could never fit
+	if (size <= _scriptCacheMaxBytes) {
+		while (_scriptCacheTail && _scriptCacheBytes + size > _scriptCacheMaxBytes) {
+			removeFromScriptCache(_scriptCacheTail);
+			_scriptCacheEvictions++;
 		}
-		_cachedScripts[index] = cachedScript;
 
-		ret = cachedScript->_buffer;
-		*outSize = cachedScript->_size;
+		CachedScript *cachedScript = new CachedScript();
+		cachedScript->_filename = filename;
+		cachedScript->_buffer = compBuffer;
+		cachedScript->_size = size;
+		addToScriptCache(cachedScript);
+		_scriptCache[cachedScript->_filename] = cachedScript;
+		_scriptCacheBytes += size;
 	}
 
+	return compBuffer;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::addToScriptCache(CachedScript *script) {
+	script->_prev = nullptr;
+	script->_next = _scriptCacheHead;
+	if (_scriptCacheHead) {
+		_scriptCacheHead->_prev = script;
+	} else {
+		_scriptCacheTail = script;
+	}
+	_scriptCacheHead = script;
+}
 
-	// cleanup
-	delete[] buffer;
 
-	return ret;
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::detachFromScriptCache(CachedScript *script) {
+	if (script->_prev) {
+		script->_prev->_next = script->_next;
+	} else {
+		_scriptCacheHead = script->_next;
+	}
+	if (script->_next) {
+		script->_next->_prev = script->_prev;
+	} else {
+		_scriptCacheTail = script->_prev;
+	}
+	script->_prev = script->_next = nullptr;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::removeFromScriptCache(CachedScript *script) {
+	detachFromScriptCache(script);
+	_scriptCache.erase(script->_filename);
+	_scriptCacheBytes -= script->_size;
+	// scripts still running keep their own reference to the buffer
+	delete script;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::resetScriptCacheStats() {
+	_scriptCacheHits = 0;
+	_scriptCacheMisses = 0;
+	_scriptCacheEvictions = 0;
 }
 
 
@@ -454,11 +494,8 @@ int ScEngine::getNumScripts(int *running, int *waiting, int *persistent) {
 
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::emptyScriptCache() {
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		if (_cachedScripts[i]) {
-			delete _cachedScripts[i];
-			_cachedScripts[i] = nullptr;
-		}
+	while (_scriptCacheHead) {
+		removeFromScriptCache(_scriptCacheHead);
 	}
 	return STATUS_OK;
 }
@@ -32,38 +32,27 @@
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/base/base.h"
+#include "engines/wintermute/base/scriptables/script.h"
+#include "common/hash-str.h"
 
 namespace Wintermute {
 
-#define MAX_CACHED_SCRIPTS 20
 class ScScript;
 class ScValue;
 class BaseObject;
 class BaseScriptHolder;
 class ScEngine : public BaseClass {
 public:
-	class CScCachedScript {
-	public:
-		CScCachedScript(const char *filename, byte *buffer, uint32 size) {
-			_timestamp = g_system->getMillis();
-			_buffer = new byte[size];
-			if (_buffer) {
-				memcpy(_buffer, buffer, size);
-			}
-			_size = size;
-			_filename = filename;
-		};
-
-		~CScCachedScript() {
-			if (_buffer) {
-				delete[] _buffer;
-			}
-		};
-
-		uint32 _timestamp;
-		byte *_buffer;
-		uint32 _size;
+	/**
+	 * A compiled script kept in the script cache. The cached scripts form
+	 * a list ordered from the most to the least recently used one.
+	 */
+	struct CachedScript {
 		Common::String _filename;
+		ScriptBuffer _buffer;
+		uint32 _size;
+		CachedScript *_prev;
+		CachedScript *_next;
 	};
 
 public:
@@ -79,7 +68,15 @@ public:
 	bool resetObject(BaseObject *Object);
 	bool resetScript(ScScript *script);
 	bool emptyScriptCache();
-	byte *getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache = false);
+	ScriptBuffer getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache = false);
+
+	uint32 getScriptCacheHits() const { return _scriptCacheHits; }
+	uint32 getScriptCacheMisses() const { return _scriptCacheMisses; }
+	uint32 getScriptCacheEvictions() const { return _scriptCacheEvictions; }
+	uint32 getScriptCacheBytes() const { return _scriptCacheBytes; }
+	uint32 getScriptCacheMaxBytes() const { return _scriptCacheMaxBytes; }
+	uint getScriptCacheCount() const { return _scriptCache.size(); }
+	void resetScriptCacheStats();
 	DECLARE_PERSISTENT(ScEngine, BaseClass)
 	bool cleanup();
 	int getNumScripts(int *running = nullptr, int *waiting = nullptr, int *persistent = nullptr);
@@ -106,8 +103,23 @@ public:
 	void dumpStats();
 
 private:
+	/** Default byte budget of the script cache, see the script_cache_size setting */
+	static const uint32 kDefaultScriptCacheSize = 1024 * 1024;
+
+	void addToScriptCache(CachedScript *script);
+	void detachFromScriptCache(CachedScript *script);
+	void removeFromScriptCache(CachedScript *script);
+
+	typedef Common::HashMap<Common::String, CachedScript *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ScriptCache;
+	ScriptCache _scriptCache;
+	CachedScript *_scriptCacheHead;
+	CachedScript *_scriptCacheTail;
+	uint32 _scriptCacheBytes;
+	uint32 _scriptCacheMaxBytes;
+	uint32 _scriptCacheHits;
+	uint32 _scriptCacheMisses;
+	uint32 _scriptCacheEvictions;
 
-	CScCachedScript *_cachedScripts[MAX_CACHED_SCRIPTS];
 	bool _isProfiling;
 	uint32 _profilingStartTime;
 
@@ -23,6 +23,10 @@
 #include "engines/wintermute/debugger.h"
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_file_manager.h"
+#include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/base_surface_storage.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
+#include "engines/wintermute/base/scriptables/script_engine.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/debugger/debugger_controller.h"
 #include "engines/wintermute/wintermute.h"
@@ -36,6 +40,9 @@ Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("transform_cache", WRAP_METHOD(Console, Cmd_TransformCache));
+	registerCmd("surface_storage", WRAP_METHOD(Console, Cmd_SurfaceStorage));
+	registerCmd("script_cache", WRAP_METHOD(Console, Cmd_ScriptCache));
 	registerCmd("help", WRAP_METHOD(Console, Cmd_Help));
 	// Actual (script) debugger commands
 	registerCmd(STEP_CMD, WRAP_METHOD(Console, Cmd_Step));
@@ -308,6 +315,73 @@ bool Console::Cmd_ShowFps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_TransformCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && Common::String(argv[1]) != "clear")) {
+		debugPrintf("Usage: %s [clear]\n", argv[0]);
+		return true;
+	}
+
+	if (!_engineRef->_game || !_engineRef->_game->_renderer) {
+		debugPrintf("The renderer is not running\n");
+		return true;
+	}
+
+	Graphics::TransformedSurfaceCache &cache = static_cast<BaseRenderOSystem *>(_engineRef->_game->_renderer)->getTransformCache();
+	if (argc == 2) {
+		cache.clear();
+		cache.resetStats();
+		debugPrintf("Transform cache cleared\n");
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Entries: %u, using %u of %u KB\n", cache.getEntryCount(), cache.getBytes() / 1024, cache.getMaxBytes() / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate), evictions: %u\n", cache.getHits(), cache.getMisses(),
+	            lookups ? cache.getHits() * 100 / lookups : 0, cache.getEvictions());
+	return true;
+}
+
+bool Console::Cmd_SurfaceStorage(int argc, const char **argv) {
+	if (!_engineRef->_game || !_engineRef->_game->_surfaceStorage) {
+		debugPrintf("The surface storage is not running\n");
+		return true;
+	}
+
+	const BaseSurfaceStorage *storage = _engineRef->_game->_surfaceStorage;
+	debugPrintf("Surfaces: %u, waiting to be decoded: %u\n", storage->_surfaces.size(), storage->getPreloadQueueSize());
+	debugPrintf("Decoded ahead of use: %u in %u ms\n", storage->getPreloadCount(), storage->getPreloadTime());
+	debugPrintf("Decoded when first used: %u in %u ms (longest %u ms)\n", storage->getBlockingLoadCount(),
+	            storage->getBlockingLoadTime(), storage->getMaxBlockingLoadTime());
+	return true;
+}
+
+bool Console::Cmd_ScriptCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && Common::String(argv[1]) != "clear")) {
+		debugPrintf("Usage: %s [clear]\n", argv[0]);
+		return true;
+	}
+
+	if (!_engineRef->_game || !_engineRef->_game->_scEngine) {
+		debugPrintf("The script engine is not running\n");
+		return true;
+	}
+
+	ScEngine *engine = _engineRef->_game->_scEngine;
+	if (argc == 2) {
+		engine->emptyScriptCache();
+		engine->resetScriptCacheStats();
+		debugPrintf("Script cache cleared\n");
+		return true;
+	}
+
+	const uint32 lookups = engine->getScriptCacheHits() + engine->getScriptCacheMisses();
+	debugPrintf("Scripts: %u, using %u of %u KB\n", engine->getScriptCacheCount(),
+	            engine->getScriptCacheBytes() / 1024, engine->getScriptCacheMaxBytes() / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate), evictions: %u\n", engine->getScriptCacheHits(), engine->getScriptCacheMisses(),
+	            lookups ? engine->getScriptCacheHits() * 100 / lookups : 0, engine->getScriptCacheEvictions());
+	return true;
+}
+
 bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	if (argc != 3) {
 		debugPrintf("Usage: %s <file path> <output file name>\n", argv[0]);
@@ -70,6 +70,19 @@ public:
 	bool Cmd_Help(int argc, const char **argv);
 	bool Cmd_ShowFps(int argc, const char **argv);
 	bool Cmd_DumpFile(int argc, const char **argv);
+	/**
+	 * Shows the hit rate of the scaled/rotated sprite cache, or clears it
+	 */
+	bool Cmd_TransformCache(int argc, const char **argv);
+	/**
+	 * Shows how many images were decoded ahead of time, and how long the
+	 * game waited for the others
+	 */
+	bool Cmd_SurfaceStorage(int argc, const char **argv);
+	/**
+	 * Shows the hit rate of the compiled script cache, or clears it
+	 */
+	bool Cmd_ScriptCache(int argc, const char **argv);
 
 #if EXTENDED_DEBUGGER_ENABLED
 	/**
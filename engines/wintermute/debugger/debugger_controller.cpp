@@ -52,7 +52,7 @@ DebuggerController::DebuggerController(WintermuteEngine *vm) : _engine(vm) {
 
 bool DebuggerController::bytecodeExists(const Common::String &filename) {
 	uint32 compSize;
-	byte *compBuffer = SCENGINE->getCompiledScript(filename.c_str(), &compSize);
+	ScriptBuffer compBuffer = SCENGINE->getCompiledScript(filename.c_str(), &compSize);
 	if (!compBuffer) {
 		return false;
 	} else {
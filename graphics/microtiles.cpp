@@ -0,0 +1,209 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/microtiles.h"
+
+namespace Graphics {
+
+MicroTileArray::MicroTileArray() : _width(0), _height(0), _tilesW(0), _tilesH(0), _tiles(nullptr), _openRects(nullptr) {
+}
+
+MicroTileArray::MicroTileArray(int16 width, int16 height) : _width(0), _height(0), _tilesW(0), _tilesH(0), _tiles(nullptr), _openRects(nullptr) {
+	resize(width, height);
+}
+
+MicroTileArray::~MicroTileArray() {
+	delete[] _tiles;
+	delete[] _openRects;
+}
+
+void MicroTileArray::resize(int16 width, int16 height) {
+	if (width != _width || height != _height) {
+		delete[] _tiles;
+		delete[] _openRects;
+		_tiles = nullptr;
+		_openRects = nullptr;
+
+		_width = MAX<int16>(width, 0);
+		_height = MAX<int16>(height, 0);
+		_tilesW = (_width + kTileSize - 1) / kTileSize;
+		_tilesH = (_height + kTileSize - 1) / kTileSize;
+		if (_tilesW * _tilesH > 0) {
+			_tiles = new BoundingBox[_tilesW * _tilesH];
+			_openRects = new uint[2 * _tilesW];
+			for (int i = 0; i < _tilesW * _tilesH; ++i)
+				_tiles[i] = kEmptyBoundingBox;
+		}
+		_bounds = Common::Rect();
+	} else {
+		clear();
+	}
+}
+
+MicroTileArray::BoundingBox MicroTileArray::unionBoundingBox(BoundingBox box, uint x0, uint y0, uint x1, uint y1) {
+	return makeBoundingBox(MIN<uint>(tileX0(box), x0), MIN<uint>(tileY0(box), y0),
+	                       MAX<uint>(tileX1(box), x1), MAX<uint>(tileY1(box), y1));
+}
+
+void MicroTileArray::addRect(const Common::Rect &rect) {
+	Common::Rect r(rect);
+	r.clip(Common::Rect(_width, _height));
+	if (r.isEmpty())
+		return;
+
+	if (_bounds.isEmpty())
+		_bounds = r;
+	else
+		_bounds.extend(r);
+
+	const int ux0 = r.left / kTileSize;
+	const int uy0 = r.top / kTileSize;
+	const int ux1 = (r.right - 1) / kTileSize;
+	const int uy1 = (r.bottom - 1) / kTileSize;
+
+	const int tx0 = r.left % kTileSize;
+	const int ty0 = r.top % kTileSize;
+	const int tx1 = (r.right - 1) % kTileSize;
+	const int ty1 = (r.bottom - 1) % kTileSize;
+
+	for (int yc = uy0; yc <= uy1; ++yc) {
+		BoundingBox *row = _tiles + yc * _tilesW;
+		const int iy0 = (yc == uy0) ? ty0 : 0;
+		const int iy1 = (yc == uy1) ? ty1 : kTileSize - 1;
+
+		row[ux0] = unionBoundingBox(row[ux0], tx0, iy0, (ux0 == ux1) ? tx1 : kTileSize - 1, iy1);
+		if (ux0 == ux1)
+			continue;
+
+		// Tiles between the first and the last one are covered horizontally
+		if (iy0 == 0 && iy1 == kTileSize - 1) {
+			for (int xc = ux0 + 1; xc < ux1; ++xc)
+				row[xc] = kFullBoundingBox;
+		} else {
+			for (int xc = ux0 + 1; xc < ux1; ++xc)
+				row[xc] = unionBoundingBox(row[xc], 0, iy0, kTileSize - 1, iy1);
+		}
+
+		row[ux1] = unionBoundingBox(row[ux1], 0, iy0, tx1, iy1);
+	}
+}
+
+void MicroTileArray::addAll() {
+	addRect(Common::Rect(_width, _height));
+}
+
+void MicroTileArray::clear() {
+	if (_bounds.isEmpty())
+		return;
+
+	// Only the tiles inside the dirty bounds can be set
+	const int ux0 = _bounds.left / kTileSize;
+	const int uy0 = _bounds.top / kTileSize;
+	const int ux1 = (_bounds.right - 1) / kTileSize;
+	const int uy1 = (_bounds.bottom - 1) / kTileSize;
+
+	for (int yc = uy0; yc <= uy1; ++yc) {
+		BoundingBox *row = _tiles + yc * _tilesW;
+		for (int xc = ux0; xc <= ux1; ++xc)
+			row[xc] = kEmptyBoundingBox;
+	}
+
+	_bounds = Common::Rect();
+}
+
+void MicroTileArray::getRectangles(Common::Array<Common::Rect> &rects) const {
+	if (_bounds.isEmpty())
+		return;
+
+	const int ux0 = _bounds.left / kTileSize;
+	const int uy0 = _bounds.top / kTileSize;
+	const int ux1 = (_bounds.right - 1) / kTileSize;
+	const int uy1 = (_bounds.bottom - 1) / kTileSize;
+
+	// Indices of the rectangles that reach the bottom edge of the previous
+	// tile row, and thus may be continued by the current one. Both lists
+	// are sorted from left to right.
+	uint *open = _openRects;
+	uint *nextOpen = _openRects + _tilesW;
+	uint openCount = 0;
+
+	for (int y = uy0; y <= uy1; ++y) {
+		const BoundingBox *row = _tiles + y * _tilesW;
+		uint openPos = 0;
+		uint nextOpenCount = 0;
+
+		for (int x = ux0; x <= ux1; ++x) {
+			BoundingBox box = row[x];
+			if (box == kEmptyBoundingBox)
+				continue;
+
+			const int x0 = x * kTileSize + tileX0(box);
+			const int y0 = y * kTileSize + tileY0(box);
+			const int y1 = y * kTileSize + tileY1(box) + 1;
+
+			// Join the following tiles as long as the area continues into them
+			while (tileX1(box) == kTileSize - 1 && x < ux1) {
+				const BoundingBox next = row[x + 1];
+				if (next == kEmptyBoundingBox || tileX0(next) != 0 ||
+				    tileY0(next) != tileY0(box) || tileY1(next) != tileY1(box))
+					break;
+				box = next;
+				++x;
+			}
+
+			const int x1 = x * kTileSize + tileX1(box) + 1;
+
+			// Continue a rectangle of the previous row with the same columns
+			uint index = rects.size();
+			if (tileY0(box) == 0) {
+				while (openPos < openCount && rects[open[openPos]].left < x0)
+					++openPos;
+				if (openPos < openCount) {
+					Common::Rect &above = rects[open[openPos]];
+					if (above.left == x0 && above.right == x1 && above.bottom == y0) {
+						above.bottom = y1;
+						index = open[openPos];
+					}
+				}
+			}
+
+			if (index == rects.size())
+				rects.push_back(Common::Rect(x0, y0, x1, y1));
+
+			if (tileY1(box) == kTileSize - 1)
+				nextOpen[nextOpenCount++] = index;
+		}
+
+		SWAP(open, nextOpen);
+		openCount = nextOpenCount;
+	}
+}
+
+void MicroTileArray::getRectangles(Common::List<Common::Rect> &rects) const {
+	Common::Array<Common::Rect> array;
+	getRectangles(array);
+
+	for (uint i = 0; i < array.size(); ++i)
+		rects.push_back(array[i]);
+}
+
+} // End of namespace Graphics
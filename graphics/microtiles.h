@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_MICROTILES_H
+#define GRAPHICS_MICROTILES_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * Tracks the dirty areas of a surface.
+ *
+ * The surface is divided into tiles of 32x32 pixels, and each tile stores
+ * the bounding box of the pixels changed inside of it. Adding a rectangle
+ * is therefore constant time per touched tile, no matter how many
+ * rectangles were added before, and overlapping updates are merged for
+ * free. When the dirty areas are extracted, horizontally and vertically
+ * adjacent tile boxes are joined back into as few rectangles as possible,
+ * which keeps the number of calls to OSystem::copyRectToScreen low.
+ */
+class MicroTileArray {
+public:
+	enum {
+		kTileSize = 32
+	};
+
+	MicroTileArray();
+	MicroTileArray(int16 width, int16 height);
+	~MicroTileArray();
+
+	/**
+	 * Changes the size of the tracked area. This also clears all dirty areas.
+	 */
+	void resize(int16 width, int16 height);
+
+	int16 getWidth() const { return _width; }
+	int16 getHeight() const { return _height; }
+
+	/**
+	 * Marks an area as dirty. The rectangle is clipped to the tracked area;
+	 * as usual, its right and bottom edges are exclusive.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Marks the whole tracked area as dirty.
+	 */
+	void addAll();
+
+	/**
+	 * Clears all dirty areas.
+	 */
+	void clear();
+
+	/**
+	 * Returns true if no area has been marked as dirty since the last clear.
+	 */
+	bool isEmpty() const { return _bounds.isEmpty(); }
+
+	/**
+	 * Returns the bounding rectangle of all dirty areas.
+	 */
+	const Common::Rect &getBoundingRect() const { return _bounds; }
+
+	/**
+	 * Appends the dirty areas to the given array. The returned rectangles
+	 * do not overlap.
+	 */
+	void getRectangles(Common::Array<Common::Rect> &rects) const;
+
+	/**
+	 * Appends the dirty areas to the given list. The returned rectangles
+	 * do not overlap.
+	 */
+	void getRectangles(Common::List<Common::Rect> &rects) const;
+
+private:
+	/**
+	 * The inclusive bounding box of the dirty pixels of a tile, packed as
+	 * x0 << 24 | y0 << 16 | x1 << 8 | y1. An empty box has its start after
+	 * its end, so that adding to a box is just a minimum and a maximum for
+	 * each edge.
+	 */
+	typedef uint32 BoundingBox;
+
+	static const BoundingBox kEmptyBoundingBox = 0xFFFF0000;
+	static const BoundingBox kFullBoundingBox = ((kTileSize - 1) << 8) | (kTileSize - 1);
+
+	static byte tileX0(BoundingBox box) { return (box >> 24) & 0xFF; }
+	static byte tileY0(BoundingBox box) { return (box >> 16) & 0xFF; }
+	static byte tileX1(BoundingBox box) { return (box >> 8) & 0xFF; }
+	static byte tileY1(BoundingBox box) { return box & 0xFF; }
+
+	static BoundingBox makeBoundingBox(uint x0, uint y0, uint x1, uint y1) {
+		return (x0 << 24) | (y0 << 16) | (x1 << 8) | y1;
+	}
+
+	static BoundingBox unionBoundingBox(BoundingBox box, uint x0, uint y0, uint x1, uint y1);
+
+	int16 _width, _height;
+	int16 _tilesW, _tilesH;
+	BoundingBox *_tiles;
+
+	/** Scratch space for getRectangles(), two rows of rectangle indices */
+	uint *_openRects;
+
+	/** The bounding rectangle of all dirty areas, in pixels */
+	Common::Rect _bounds;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -17,6 +17,7 @@ MODULE_OBJS := \
 	macgui/macwindowborder.o \
 	macgui/macwindowmanager.o \
 	managed_surface.o \
+	microtiles.o \
 	nine_patch.o \
 	pixelformat.o \
 	primitives.o \
@@ -27,6 +28,7 @@ MODULE_OBJS := \
 	surface.o \
 	transform_struct.o \
 	transform_tools.o \
+	transformed_surface_cache.o \
 	transparent_surface.o \
 	thumbnail.o \
 	VectorRenderer.o \
@@ -26,6 +26,12 @@
 #include "common/scummsys.h"
 #include "graphics/surface.h"
 
+/**
+ * Init the scaler subsystem.
+ *
+ * @param BitFormat	the pixel format of the scaled surfaces, 555 or 565 for
+ *					16 bit pixels, or 8888 for 32 bit pixels
+ */
 extern void InitScalers(uint32 BitFormat);
 extern void DestroyScalers();
 
@@ -26,6 +26,24 @@
 #include "common/scummsys.h"
 #include "graphics/colormasks.h"
 
+/**
+ * Maps the number of bytes per pixel of a ColorMask to the type used
+ * to store one pixel.
+ */
+template<int bytesPerPixel>
+struct PixelType {
+};
+
+template<>
+struct PixelType<2> {
+	typedef uint16 Type;
+};
+
+template<>
+struct PixelType<4> {
+	typedef uint32 Type;
+};
+
 
 /**
  * Interpolate two 16 bit pixel *pairs* at once with equal weights 1.
@@ -179,6 +197,81 @@ static inline unsigned interpolate16_1_1_1_1(unsigned p1, unsigned p2, unsigned
 	return ((p1+p2+p3+p4) - lowbits) >> 2;
 }
 
+/**
+ * Interpolate up to four 32 bit pixels with 8 bits per channel, with the
+ * weights w1 to w4, whose sum must be (1 << shift) and at most 16. The
+ * channels are processed pairwise in two 16 bit lanes, so this works for
+ * any channel order, and the alpha channel is interpolated as well.
+ */
+template<int w1, int w2, int w3, int w4, int shift>
+static inline uint32 interpolate32Weighted(uint32 p1, uint32 p2, uint32 p3, uint32 p4) {
+	const uint32 rb = (((p1 & 0x00FF00FF) * w1 + (p2 & 0x00FF00FF) * w2
+	                  + (p3 & 0x00FF00FF) * w3 + (p4 & 0x00FF00FF) * w4) >> shift) & 0x00FF00FF;
+	const uint32 ag = ((((p1 >> 8) & 0x00FF00FF) * w1 + ((p2 >> 8) & 0x00FF00FF) * w2
+	                  + ((p3 >> 8) & 0x00FF00FF) * w3 + ((p4 >> 8) & 0x00FF00FF) * w4) >> shift) & 0x00FF00FF;
+	return rb | (ag << 8);
+}
+
+/*
+ * 32 bit versions of the interpolation functions above. The scaler templates
+ * are instantiated with ColorMasks<8888> for 32 bit pixels, which then picks
+ * these specializations.
+ */
+template<>
+inline unsigned interpolate16_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Weighted<1, 1, 0, 0, 1>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_3_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Weighted<3, 1, 0, 0, 2>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_5_3<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Weighted<5, 3, 0, 0, 3>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_7_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Weighted<7, 1, 0, 0, 3>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<2, 1, 1, 0, 2>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_5_2_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<5, 2, 1, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_6_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<6, 1, 1, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_3_3<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<2, 3, 3, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_7_7<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<2, 7, 7, 0, 4>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_14_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Weighted<14, 1, 1, 0, 4>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_1_1_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3, unsigned p4) {
+	return interpolate32Weighted<1, 1, 1, 1, 2>(p1, p2, p3, p4);
+}
+
 /**
  * Compare two YUV values (encoded 8-8-8) and check if they differ by more than
  * a certain hard coded threshold. Used by the hq scaler family.
@@ -218,4 +311,34 @@ static inline bool diffYUV(int yuv1, int yuv2) {
 */
 }
 
+#ifdef USE_HQ_SCALERS
+extern "C" uint32 *RGBtoYUV;
+
+/**
+ * Convert a pixel to YUV (encoded 8-8-8). Used by the hq scaler family.
+ * 16 bit pixels are looked up in the RGBtoYUV table, which is set up by
+ * InitScalers().
+ */
+template<typename ColorMask>
+static inline int convertToYUV(unsigned color) {
+	return RGBtoYUV[color];
+}
+
+/**
+ * 32 bit pixels would need a 64 MB lookup table, so these are converted
+ * on the fly, using the same formula as the table.
+ */
+template<>
+inline int convertToYUV<Graphics::ColorMasks<8888> >(unsigned color) {
+	typedef Graphics::ColorMasks<8888> ColorMask;
+	const int r = (color & ColorMask::kRedMask) >> ColorMask::kRedShift;
+	const int g = (color & ColorMask::kGreenMask) >> ColorMask::kGreenShift;
+	const int b = (color & ColorMask::kBlueMask) >> ColorMask::kBlueShift;
+	const int Y = (r + g + b) >> 2;
+	const int u = 128 + ((r - b) >> 2);
+	const int v = 128 + ((-r + 2 * g - b) >> 3);
+	return (Y << 16) | (u << 8) | v;
+}
+#endif
+
 #endif
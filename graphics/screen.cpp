@@ -40,12 +40,13 @@ Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface()
 }
 
 void Screen::update() {
-	// Merge the dirty rects
-	mergeDirtyRects();
+	// Fetch the dirty areas, with adjacent ones merged together
+	Common::List<Common::Rect> dirtyRects;
+	_dirtyTiles.getRectangles(dirtyRects);
 
 	// Loop through copying dirty areas to the physical screen
 	Common::List<Common::Rect>::iterator i;
-	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
+	for (i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
 		const Common::Rect &r = *i;
 		const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
 		g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
@@ -54,7 +55,7 @@ void Screen::update() {
 
 	// Signal the physical screen to update
 	g_system->updateScreen();
-	_dirtyRects.clear();
+	_dirtyTiles.clear();
 }
 
 
@@ -63,41 +64,24 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.clip(getBounds());
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
-	if (bounds.width() > 0 && bounds.height() > 0)
-		_dirtyRects.push_back(bounds);
-}
-
-void Screen::makeAllDirty() {
-	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
-}
-
-void Screen::mergeDirtyRects() {
-	Common::List<Common::Rect>::iterator rOuter, rInner;
-
-	// Process the dirty rect list to find any rects to merge
-	for (rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
-		rInner = rOuter;
-		while (++rInner != _dirtyRects.end()) {
+	if (bounds.width() > 0 && bounds.height() > 0) {
+		const int16 width = getOffsetFromOwner().x + this->w;
+		const int16 height = getOffsetFromOwner().y + this->h;
 
-			if ((*rOuter).intersects(*rInner)) {
-				// These two rectangles overlap, so merge them
-				unionRectangle(*rOuter, *rOuter, *rInner);
-
-				// remove the inner rect from the list
-				_dirtyRects.erase(rInner);
-
-				// move back to beginning of list
-				rInner = rOuter;
-			}
+		if (_dirtyTiles.getWidth() != width || _dirtyTiles.getHeight() != height) {
+			// The screen has been resized, so redraw all of it if anything was pending
+			const bool wasDirty = !_dirtyTiles.isEmpty();
+			_dirtyTiles.resize(width, height);
+			if (wasDirty)
+				_dirtyTiles.addAll();
 		}
+
+		_dirtyTiles.addRect(bounds);
 	}
 }
 
-bool Screen::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
-	destRect = src1;
-	destRect.extend(src2);
-
-	return !destRect.isEmpty();
+void Screen::makeAllDirty() {
+	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
 }
 
 void Screen::getPalette(byte palette[PALETTE_SIZE]) {
@@ -0,0 +1,182 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transformed_surface_cache.h"
+#include "graphics/transparent_surface.h"
+
+namespace Graphics {
+
+uint TransformedSurfaceCache::KeyHash::operator()(const Key &key) const {
+	uint hash = (uint)(size_t)key.owner;
+	hash = hash * 31 + ((uint16)key.srcRect.left | ((uint)(uint16)key.srcRect.top << 16));
+	hash = hash * 31 + ((uint16)key.srcRect.right | ((uint)(uint16)key.srcRect.bottom << 16));
+	hash = hash * 31 + (key.width | ((uint)key.height << 16));
+	hash = hash * 31 + (uint)key.angle;
+	hash = hash * 31 + ((uint16)key.zoom.x | ((uint)(uint16)key.zoom.y << 16));
+	hash = hash * 31 + ((uint16)key.hotspot.x | ((uint)(uint16)key.hotspot.y << 16));
+	return hash;
+}
+
+TransformedSurfaceCache::TransformedSurfaceCache(uint32 maxBytes) :
+	_maxBytes(maxBytes),
+	_bytes(0),
+	_head(nullptr),
+	_tail(nullptr),
+	_hits(0),
+	_misses(0),
+	_evictions(0) {}
+
+TransformedSurfaceCache::~TransformedSurfaceCache() {
+	clear();
+}
+
+TransformedSurfaceCache::SurfacePtr TransformedSurfaceCache::scale(const void *owner, const Common::Rect &srcRect, const TransparentSurface &src, uint16 newWidth, uint16 newHeight) {
+	Key key;
+	key.owner = owner;
+	key.srcRect = srcRect;
+	key.width = newWidth;
+	key.height = newHeight;
+	key.angle = 0;
+
+	SurfacePtr surface = find(key);
+	if (!surface) {
+		surface = insert(key, src.scale(newWidth, newHeight));
+	}
+	return surface;
+}
+
+TransformedSurfaceCache::SurfacePtr TransformedSurfaceCache::rotoscale(const void *owner, const Common::Rect &srcRect, const TransparentSurface &src, const TransformStruct &transform) {
+	Key key;
+	key.owner = owner;
+	key.srcRect = srcRect;
+	key.width = 0;
+	key.height = 0;
+	key.angle = transform._angle;
+	key.zoom = transform._zoom;
+	key.hotspot = transform._hotspot;
+
+	SurfacePtr surface = find(key);
+	if (!surface) {
+		surface = insert(key, src.rotoscale(transform));
+	}
+	return surface;
+}
+
+void TransformedSurfaceCache::invalidate(const void *owner) {
+	Entry *entry = _head;
+	while (entry) {
+		Entry *next = entry->next;
+		if (entry->key.owner == owner) {
+			remove(entry);
+		}
+		entry = next;
+	}
+}
+
+void TransformedSurfaceCache::clear() {
+	while (_head) {
+		remove(_head);
+	}
+}
+
+void TransformedSurfaceCache::setMaxBytes(uint32 maxBytes) {
+	_maxBytes = maxBytes;
+	evict();
+}
+
+TransformedSurfaceCache::SurfacePtr TransformedSurfaceCache::find(const Key &key) {
+	EntryMap::iterator it = _entries.find(key);
+	if (it == _entries.end()) {
+		++_misses;
+		return SurfacePtr();
+	}
+
+	++_hits;
+	Entry *entry = it->_value;
+	if (entry != _head) {
+		detach(entry);
+		attachAtFront(entry);
+	}
+	return entry->surface;
+}
+
+TransformedSurfaceCache::SurfacePtr TransformedSurfaceCache::insert(const Key &key, Surface *surface) {
+	SurfacePtr ptr(surface, SharedPtrSurfaceDeleter());
+
+	const uint32 size = surface->h * surface->pitch;
+	if (size > _maxBytes) {
+		// Larger than the whole budget, do not bother caching it
+		return ptr;
+	}
+
+	Entry *entry = new Entry();
+	entry->key = key;
+	entry->surface = ptr;
+	entry->size = size;
+	_entries[key] = entry;
+	attachAtFront(entry);
+	_bytes += size;
+
+	evict();
+	return ptr;
+}
+
+void TransformedSurfaceCache::detach(Entry *entry) {
+	if (entry->prev) {
+		entry->prev->next = entry->next;
+	} else {
+		_head = entry->next;
+	}
+
+	if (entry->next) {
+		entry->next->prev = entry->prev;
+	} else {
+		_tail = entry->prev;
+	}
+}
+
+void TransformedSurfaceCache::attachAtFront(Entry *entry) {
+	entry->prev = nullptr;
+	entry->next = _head;
+	if (_head) {
+		_head->prev = entry;
+	} else {
+		_tail = entry;
+	}
+	_head = entry;
+}
+
+void TransformedSurfaceCache::remove(Entry *entry) {
+	detach(entry);
+	_entries.erase(entry->key);
+	_bytes -= entry->size;
+	delete entry;
+}
+
+void TransformedSurfaceCache::evict() {
+	while (_bytes > _maxBytes && _tail) {
+		remove(_tail);
+		++_evictions;
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+#define GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/ptr.h"
+#include "common/rect.h"
+#include "graphics/transform_struct.h"
+
+namespace Graphics {
+
+struct Surface;
+struct TransparentSurface;
+
+/**
+ * A bounded cache of scaled and rotated copies of TransparentSurfaces.
+ *
+ * Sprites are usually drawn at the same zoom or rotation for many frames in
+ * a row. Rather than resampling them on every draw, the transformed copies
+ * are kept here until their total size exceeds the memory budget, at which
+ * point the least recently used ones are dropped.
+ *
+ * Sources are identified by an opaque owner pointer and the rectangle of
+ * the owner which was transformed. The cache cannot tell when the pixels of
+ * an owner change, so owners must call invalidate() whenever that happens
+ * and before they are destroyed.
+ *
+ * The surfaces are handed out as shared pointers: they stay valid for as
+ * long as the caller holds on to them, even after being evicted.
+ */
+class TransformedSurfaceCache {
+public:
+	typedef Common::SharedPtr<Surface> SurfacePtr;
+
+	enum {
+		/** The default memory budget, in bytes. */
+		kDefaultMaxBytes = 16 * 1024 * 1024
+	};
+
+	TransformedSurfaceCache(uint32 maxBytes = kDefaultMaxBytes);
+	~TransformedSurfaceCache();
+
+	/**
+	 * Returns the given source scaled to newWidth x newHeight, as done by
+	 * TransparentSurface::scale.
+	 * @param owner		the object owning the pixels of src
+	 * @param srcRect	the area of the owner src covers
+	 * @param src		the pixels to scale, when they are not in the cache yet
+	 */
+	SurfacePtr scale(const void *owner, const Common::Rect &srcRect, const TransparentSurface &src, uint16 newWidth, uint16 newHeight);
+
+	/**
+	 * Returns the given source transformed by TransparentSurface::rotoscale.
+	 * @see scale
+	 */
+	SurfacePtr rotoscale(const void *owner, const Common::Rect &srcRect, const TransparentSurface &src, const TransformStruct &transform);
+
+	/**
+	 * Drops all the transformed copies made from the given owner.
+	 */
+	void invalidate(const void *owner);
+
+	/**
+	 * Drops all the transformed copies.
+	 */
+	void clear();
+
+	/**
+	 * Changes the memory budget, evicting surfaces if necessary.
+	 */
+	void setMaxBytes(uint32 maxBytes);
+
+	uint32 getMaxBytes() const { return _maxBytes; }
+	uint32 getBytes() const { return _bytes; }
+	uint getEntryCount() const { return _entries.size(); }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getEvictions() const { return _evictions; }
+
+	void resetStats() { _hits = _misses = _evictions = 0; }
+
+private:
+	struct Key {
+		const void *owner;
+		Common::Rect srcRect;
+		/** The requested size of scaled entries, 0 for rotated ones */
+		uint16 width, height;
+		/** The transformation of rotated entries, left at 0 for scaled ones */
+		int32 angle;
+		Common::Point zoom;
+		Common::Point hotspot;
+
+		bool operator==(const Key &other) const {
+			return owner == other.owner && srcRect == other.srcRect &&
+			       width == other.width && height == other.height &&
+			       angle == other.angle && zoom == other.zoom && hotspot == other.hotspot;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	struct Entry {
+		Key key;
+		SurfacePtr surface;
+		uint32 size;
+
+		/** Neighbours in the LRU list, from most to least recently used */
+		Entry *prev, *next;
+	};
+
+	typedef Common::HashMap<Key, Entry *, KeyHash> EntryMap;
+
+	SurfacePtr find(const Key &key);
+	SurfacePtr insert(const Key &key, Surface *surface);
+
+	void detach(Entry *entry);
+	void attachAtFront(Entry *entry);
+	void remove(Entry *entry);
+	void evict();
+
+	uint32 _maxBytes;
+	uint32 _bytes;
+
+	EntryMap _entries;
+
+	/** The most and least recently used entries */
+	Entry *_head, *_tail;
+
+	uint32 _hits, _misses, _evictions;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -26,6 +26,13 @@
  */
 
 
+// SSE2 is part of the x86-64 baseline, and it is enabled on 32 bit x86 when
+// the compiler targets it. The intrinsics header has to be included before
+// any ScummVM header, as it pulls in system headers.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSPARENTSURFACE_SSE2
+#include <emmintrin.h>
+#endif
 
 #include "common/algorithm.h"
 #include "common/endian.h"
@@ -65,6 +72,246 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
+#ifdef TRANSPARENTSURFACE_SSE2
+
+static bool s_simdBlending = true;
+
+/*
+ * The SSE2 routines below blend four pixels at a time. Every channel is
+ * widened to 16 bits, so the products of two channels fit in a lane. The
+ * divisions by 256 and 65536 of the C routines map onto plain shifts and
+ * _mm_mulhi_epu16, which keeps the results identical to theirs, bit for bit.
+ * SSE2 implies a little endian host, hence the byte order of the channels
+ * is the one of kAIndex and friends on SCUMM_LITTLE_ENDIAN.
+ */
+
+/** Returns a vector holding the given channel values for each pixel of a 16 bit lane pair. */
+static inline __m128i setChannels16(uint16 a, uint16 r, uint16 g, uint16 b) {
+	uint16 lanes[4];
+	lanes[kAIndex] = a;
+	lanes[kRIndex] = r;
+	lanes[kGIndex] = g;
+	lanes[kBIndex] = b;
+	return _mm_set_epi16(lanes[3], lanes[2], lanes[1], lanes[0], lanes[3], lanes[2], lanes[1], lanes[0]);
+}
+
+/** Copies the alpha value of each pixel to all its 16 bit channels. */
+static inline __m128i broadcastAlpha16(__m128i pixels) {
+	pixels = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	return _mm_shufflehi_epi16(pixels, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+}
+
+/** Returns the mask of the alpha byte of each pixel. */
+static inline __m128i alphaMask32() {
+	return _mm_set1_epi32(0xFF << (kAIndex * 8));
+}
+
+/**
+ * Returns a mask selecting the pixels of src which are fully transparent.
+ */
+static inline __m128i transparentMask32(__m128i src) {
+	return _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask32()), _mm_setzero_si128());
+}
+
+/**
+ * Multiplier which makes _mm_mulhi_epu16 compute x * c >> 16 when the
+ * C routines do so, and x >> 8 where they skip the colour modulation of
+ * a channel with c == 255.
+ */
+static inline uint16 modMultiplier(byte c) {
+	return c == 255 ? 256 : c;
+}
+
+struct BinaryOpSSE2 {
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i transparent = transparentMask32(src);
+		const __m128i res = _mm_or_si128(src, alphaMask32());
+		return _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, res));
+	}
+};
+
+struct AlphaBlendOpSSE2 {
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(255);
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			const __m128i d = half ? _mm_unpackhi_epi8(dst, zero) : _mm_unpacklo_epi8(dst, zero);
+			const __m128i a = broadcastAlpha16(s);
+			res[half] = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(full, a))), 8);
+		}
+		const __m128i blended = _mm_or_si128(_mm_packus_epi16(res[0], res[1]), alphaMask32());
+		const __m128i transparent = transparentMask32(src);
+		return _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, blended));
+	}
+};
+
+struct AlphaBlendModOpSSE2 {
+	__m128i _ca;
+	__m128i _mod;
+
+	AlphaBlendModOpSSE2(byte ca, byte cr, byte cg, byte cb) {
+		_ca = _mm_set1_epi16(ca);
+		_mod = setChannels16(0, cr, cg, cb);
+	}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(255);
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			const __m128i d = half ? _mm_unpackhi_epi8(dst, zero) : _mm_unpacklo_epi8(dst, zero);
+			const __m128i ina = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha16(s), _ca), 8);
+			const __m128i faded = _mm_srli_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(full, ina)), 8);
+			res[half] = _mm_add_epi16(faded, _mm_mulhi_epu16(_mm_mullo_epi16(s, ina), _mod));
+		}
+		return _mm_or_si128(_mm_packus_epi16(res[0], res[1]), alphaMask32());
+	}
+};
+
+struct AdditiveOpSSE2 {
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = setChannels16(0, 0xFFFF, 0xFFFF, 0xFFFF);
+		__m128i add[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			add[half] = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(s, broadcastAlpha16(s)), 8), colorMask);
+		}
+		return _mm_adds_epu8(dst, _mm_packus_epi16(add[0], add[1]));
+	}
+};
+
+struct AdditiveModOpSSE2 {
+	__m128i _ca;
+	__m128i _mod;
+
+	AdditiveModOpSSE2(byte ca, byte cr, byte cg, byte cb) {
+		_ca = _mm_set1_epi16(ca);
+		_mod = setChannels16(0, modMultiplier(cr), modMultiplier(cg), modMultiplier(cb));
+	}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i add[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			const __m128i ina = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha16(s), _ca), 8);
+			add[half] = _mm_mulhi_epu16(_mm_mullo_epi16(s, ina), _mod);
+		}
+		return _mm_adds_epu8(dst, _mm_packus_epi16(add[0], add[1]));
+	}
+};
+
+struct SubtractiveOpSSE2 {
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = setChannels16(0, 0xFFFF, 0xFFFF, 0xFFFF);
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			const __m128i d = half ? _mm_unpackhi_epi8(dst, zero) : _mm_unpacklo_epi8(dst, zero);
+			const __m128i sub = _mm_mulhi_epu16(_mm_mullo_epi16(s, d), broadcastAlpha16(s));
+			res[half] = _mm_sub_epi16(d, _mm_and_si128(sub, colorMask));
+		}
+		return _mm_packus_epi16(res[0], res[1]);
+	}
+};
+
+struct SubtractiveModOpSSE2 {
+	__m128i _mod;
+
+	SubtractiveModOpSSE2(byte cr, byte cg, byte cb) {
+		_mod = setChannels16(0, modMultiplier(cr), modMultiplier(cg), modMultiplier(cb));
+	}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const __m128i s = half ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+			const __m128i d = half ? _mm_unpackhi_epi8(dst, zero) : _mm_unpacklo_epi8(dst, zero);
+			// (s * d) * (a * c) >> 24, or (s * d) * a >> 16 when c == 255
+			const __m128i factor = _mm_mullo_epi16(broadcastAlpha16(s), _mod);
+			const __m128i sub = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(s, d), factor), 8);
+			res[half] = _mm_sub_epi16(d, sub);
+		}
+		return _mm_or_si128(_mm_packus_epi16(res[0], res[1]), alphaMask32());
+	}
+};
+
+/**
+ * Applies a blending operation to every pixel, four at a time. The last
+ * pixels of a row go through a small buffer so that nothing is read or
+ * written past the end of the row.
+ */
+template<class Op>
+static void doBlitSSE2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const Op &op) {
+	for (uint32 i = 0; i < height; i++) {
+		byte *out = outo;
+		byte *in = ino;
+		uint32 j = width;
+
+		if (inStep > 0) {
+			for (; j >= 4; j -= 4) {
+				const __m128i src = _mm_loadu_si128((const __m128i *)in);
+				const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+				_mm_storeu_si128((__m128i *)out, op(src, dst));
+				in += 16;
+				out += 16;
+			}
+		} else {
+			// Horizontally flipped: the source pixels are read right to left
+			for (; j >= 4; j -= 4) {
+				const __m128i src = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+				const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+				_mm_storeu_si128((__m128i *)out, op(src, dst));
+				in -= 16;
+				out += 16;
+			}
+		}
+
+		if (j) {
+			uint32 srcTail[4] = { 0, 0, 0, 0 };
+			uint32 dstTail[4] = { 0, 0, 0, 0 };
+			for (uint32 k = 0; k < j; k++) {
+				memcpy(&srcTail[k], in, 4);
+				in += inStep;
+			}
+			memcpy(dstTail, out, j * 4);
+			const __m128i res = op(_mm_loadu_si128((const __m128i *)srcTail), _mm_loadu_si128((const __m128i *)dstTail));
+			_mm_storeu_si128((__m128i *)dstTail, res);
+			memcpy(out, dstTail, j * 4);
+		}
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+/** Whether the SSE2 routines can handle the given source pixel step. */
+static inline bool useSSE2(int32 inStep) {
+	return s_simdBlending && (inStep == 4 || inStep == -4);
+}
+
+#endif // TRANSPARENTSURFACE_SSE2
+
+bool TransparentSurface::hasSIMDBlending() {
+#ifdef TRANSPARENTSURFACE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+void TransparentSurface::setSIMDBlending(bool enable) {
+#ifdef TRANSPARENTSURFACE_SSE2
+	s_simdBlending = enable;
+#endif
+}
+
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -107,6 +354,12 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
  */
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+#ifdef TRANSPARENTSURFACE_SSE2
+	if (useSSE2(inStep)) {
+		doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, BinaryOpSSE2());
+		return;
+	}
+#endif
 
 	byte *in;
 	byte *out;
@@ -142,6 +395,18 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENTSURFACE_SSE2
+	if (useSSE2(inStep)) {
+		if (color == 0xffffffff) {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, AlphaBlendOpSSE2());
+		} else {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep,
+			           AlphaBlendModOpSSE2((color >> kAModShift) & 0xFF, (color >> kRModShift) & 0xFF, (color >> kGModShift) & 0xFF, (color >> kBModShift) & 0xFF));
+		}
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -200,6 +465,18 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * Optimized version of doBlit to be used with additive blended blitting
  */
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENTSURFACE_SSE2
+	if (useSSE2(inStep)) {
+		if (color == 0xffffffff) {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, AdditiveOpSSE2());
+		} else {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep,
+			           AdditiveModOpSSE2((color >> kAModShift) & 0xFF, (color >> kRModShift) & 0xFF, (color >> kGModShift) & 0xFF, (color >> kBModShift) & 0xFF));
+		}
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -267,6 +544,18 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
  * Optimized version of doBlit to be used with subtractive blended blitting
  */
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENTSURFACE_SSE2
+	if (useSSE2(inStep)) {
+		if (color == 0xffffffff) {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, SubtractiveOpSSE2());
+		} else {
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep,
+			           SubtractiveModOpSSE2((color >> kRModShift) & 0xFF, (color >> kGModShift) & 0xFF, (color >> kBModShift) & 0xFF));
+		}
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
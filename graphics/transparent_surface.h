@@ -163,6 +163,17 @@ struct TransparentSurface : public Graphics::Surface {
 
 	AlphaType getAlphaMode() const;
 	void setAlphaMode(AlphaType);
+
+	/**
+	 * Returns whether this build has SIMD versions of the blending routines.
+	 */
+	static bool hasSIMDBlending();
+
+	/**
+	 * Selects between the SIMD and the plain C blending routines. The SIMD
+	 * ones are used whenever available; both produce the same pixels.
+	 */
+	static void setSIMDBlending(bool enable);
 private:
 	AlphaType _alphaMode;
 
@@ -44,7 +44,8 @@ extern "C" {
 
 namespace Image {
 
-JPEGDecoder::JPEGDecoder() : _surface(), _colorSpace(kColorSpaceRGBA) {
+JPEGDecoder::JPEGDecoder() : _surface(), _colorSpace(kColorSpaceRGBA),
+	_outputPixelFormat(4, 8, 8, 8, 0, 24, 16, 8, 0) {
 }
 
 JPEGDecoder::~JPEGDecoder() {
@@ -171,6 +172,37 @@ void outputMessage(j_common_ptr cinfo) {
 	debug(3, "libjpeg: %s", buffer);
 }
 
+#ifdef JCS_ALPHA_EXTENSIONS
+// Returns the libjpeg-turbo color space writing pixels of the given format,
+// or JCS_UNKNOWN if there is none.
+J_COLOR_SPACE getExtendedColorSpace(const Graphics::PixelFormat &format) {
+	if (format.bytesPerPixel != 4 || format.rLoss != 0 || format.gLoss != 0 || format.bLoss != 0)
+		return JCS_UNKNOWN;
+	if ((format.rShift | format.gShift | format.bShift) & 7)
+		return JCS_UNKNOWN;
+	if (format.aLoss == 0 && (format.aShift & 7))
+		return JCS_UNKNOWN;
+
+	// Byte offsets of the channels in memory
+#ifdef SCUMM_LITTLE_ENDIAN
+	const int r = format.rShift / 8, g = format.gShift / 8, b = format.bShift / 8;
+#else
+	const int r = 3 - format.rShift / 8, g = 3 - format.gShift / 8, b = 3 - format.bShift / 8;
+#endif
+
+	// The alpha (or padding) byte is set to 255 by the JCS_EXT_*A* spaces
+	if (r == 0 && g == 1 && b == 2)
+		return JCS_EXT_RGBA;
+	if (r == 1 && g == 2 && b == 3)
+		return JCS_EXT_ARGB;
+	if (b == 0 && g == 1 && r == 2)
+		return JCS_EXT_BGRA;
+	if (b == 1 && g == 2 && r == 3)
+		return JCS_EXT_ABGR;
+	return JCS_UNKNOWN;
+}
+#endif
+
 } // End of anonymous namespace
 #endif
 
@@ -197,9 +229,22 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	jpeg_read_header(&cinfo, TRUE);
 
 	// We can request YUV output because Groovie requires it
+	bool directOutput = false;
 	switch (_colorSpace) {
 	case kColorSpaceRGBA:
+		if (_outputPixelFormat.bytesPerPixel != 2 && _outputPixelFormat.bytesPerPixel != 4) {
+			jpeg_destroy_decompress(&cinfo);
+			return false;
+		}
+
 		cinfo.out_color_space = JCS_RGB;
+#ifdef JCS_ALPHA_EXTENSIONS
+		// Let libjpeg-turbo write the output format itself
+		if (getExtendedColorSpace(_outputPixelFormat) != JCS_UNKNOWN) {
+			cinfo.out_color_space = getExtendedColorSpace(_outputPixelFormat);
+			directOutput = true;
+		}
+#endif
 		break;
 
 	case kColorSpaceYUV:
@@ -213,8 +258,7 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	// Allocate buffers for the output data
 	switch (_colorSpace) {
 	case kColorSpaceRGBA:
-		// We use RGBA8888 in this scenario
-		_surface.create(cinfo.output_width, cinfo.output_height, Graphics::PixelFormat(4, 8, 8, 8, 0, 24, 16, 8, 0));
+		_surface.create(cinfo.output_width, cinfo.output_height, _outputPixelFormat);
 		break;
 
 	case kColorSpaceYUV:
@@ -224,43 +268,60 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 		break;
 	}
 
-	// Allocate buffer for one scanline
-	assert(cinfo.output_components == 3);
-	JDIMENSION pitch = cinfo.output_width * cinfo.output_components;
-	assert(_surface.pitch >= pitch);
-	JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, pitch, 1);
-
-	// Go through the image data scanline by scanline
-	while (cinfo.output_scanline < cinfo.output_height) {
-		byte *dst = (byte *)_surface.getBasePtr(0, cinfo.output_scanline);
-
-		jpeg_read_scanlines(&cinfo, buffer, 1);
-
-		const byte *src = buffer[0];
-		switch (_colorSpace) {
-		case kColorSpaceRGBA: {
-			for (int remaining = cinfo.output_width; remaining > 0; --remaining) {
-				byte r = *src++;
-				byte g = *src++;
-				byte b = *src++;
-				// We need to insert a alpha value of 255 (opaque) here.
+	if (directOutput) {
+		// The scanlines are decoded straight into the surface
+		while (cinfo.output_scanline < cinfo.output_height) {
+			JSAMPROW row = (JSAMPROW)_surface.getBasePtr(0, cinfo.output_scanline);
+			jpeg_read_scanlines(&cinfo, &row, 1);
+		}
+	} else {
+		// Allocate buffer for one scanline
+		assert(cinfo.output_components == 3);
+		JDIMENSION pitch = cinfo.output_width * cinfo.output_components;
+		JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, pitch, 1);
+
+		// Go through the image data scanline by scanline
+		while (cinfo.output_scanline < cinfo.output_height) {
+			byte *dst = (byte *)_surface.getBasePtr(0, cinfo.output_scanline);
+
+			jpeg_read_scanlines(&cinfo, buffer, 1);
+
+			const byte *src = buffer[0];
+			switch (_colorSpace) {
+			case kColorSpaceRGBA:
+				if (_surface.format == Graphics::PixelFormat(4, 8, 8, 8, 0, 24, 16, 8, 0)) {
+					for (int remaining = cinfo.output_width; remaining > 0; --remaining) {
+						byte r = *src++;
+						byte g = *src++;
+						byte b = *src++;
+						// We need to insert a alpha value of 255 (opaque) here.
 #ifdef SCUMM_BIG_ENDIAN
-				*dst++ = r;
-				*dst++ = g;
-				*dst++ = b;
-				*dst++ = 0xFF;
+						*dst++ = r;
+						*dst++ = g;
+						*dst++ = b;
+						*dst++ = 0xFF;
 #else
-				*dst++ = 0xFF;
-				*dst++ = b;
-				*dst++ = g;
-				*dst++ = r;
+						*dst++ = 0xFF;
+						*dst++ = b;
+						*dst++ = g;
+						*dst++ = r;
 #endif
+					}
+				} else if (_surface.format.bytesPerPixel == 2) {
+					uint16 *dst16 = (uint16 *)dst;
+					for (int remaining = cinfo.output_width; remaining > 0; --remaining, src += 3)
+						*dst16++ = _surface.format.RGBToColor(src[0], src[1], src[2]);
+				} else {
+					uint32 *dst32 = (uint32 *)dst;
+					for (int remaining = cinfo.output_width; remaining > 0; --remaining, src += 3)
+						*dst32++ = _surface.format.RGBToColor(src[0], src[1], src[2]);
+				}
+				break;
+
+			case kColorSpaceYUV:
+				memcpy(dst, src, pitch);
+				break;
 			}
-			} break;
-
-		case kColorSpaceYUV:
-			memcpy(dst, src, pitch);
-			break;
 		}
 	}
 
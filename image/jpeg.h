@@ -92,9 +92,22 @@ public:
 	 */
 	void setOutputColorSpace(ColorSpace outSpace) { _colorSpace = outSpace; }
 
+	/**
+	 * Request the pixel format of the decoded surface when outputting RGB
+	 * data. The pixels are written straight in this format, without a
+	 * separate conversion pass. When libjpeg-turbo is used, 32bpp formats
+	 * are directly produced by its color conversion.
+	 *
+	 * The decoder itself defaults to RGBA8888, with an opaque alpha channel.
+	 *
+	 * @param format the output format, with 2 or 4 bytes per pixel
+	 */
+	void setOutputPixelFormat(const Graphics::PixelFormat &format) { _outputPixelFormat = format; }
+
 private:
 	Graphics::Surface _surface;
 	ColorSpace _colorSpace;
+	Graphics::PixelFormat _outputPixelFormat;
 };
 
 } // End of namespace Image
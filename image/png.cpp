@@ -31,6 +31,7 @@
 
 #include "image/png.h"
 
+#include "graphics/conversion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
@@ -38,7 +39,7 @@
 
 namespace Image {
 
-PNGDecoder::PNGDecoder() : _outputSurface(0), _palette(0), _paletteColorCount(0), _stream(0) {
+PNGDecoder::PNGDecoder() : _outputSurface(0), _palette(0), _paletteColorCount(0), _stream(0), _hasAlpha(false) {
 }
 
 PNGDecoder::~PNGDecoder() {
@@ -71,6 +72,51 @@ void pngReadFromStream(png_structp pngPtr, png_bytep data, png_size_t length) {
 	Common::SeekableReadStream *stream = (Common::SeekableReadStream *)readIOptr;
 	stream->read(data, length);
 }
+
+// The orders in which libpng can write the channels of 32bpp pixels
+enum ChannelOrder {
+	kOrderRGBA,
+	kOrderARGB,
+	kOrderBGRA,
+	kOrderABGR,
+	kOrderNone
+};
+
+// Returns the memory order of the channels of a format, if libpng can write it
+static ChannelOrder getChannelOrder(const Graphics::PixelFormat &format) {
+	if (format.bytesPerPixel != 4 || format.rLoss != 0 || format.gLoss != 0 || format.bLoss != 0 ||
+	    (format.aLoss != 0 && format.aLoss != 8))
+		return kOrderNone;
+	if ((format.rShift | format.gShift | format.bShift) & 7)
+		return kOrderNone;
+
+	// Byte offsets of the channels in memory. A format without alpha
+	// leaves its padding byte to the filler.
+#ifdef SCUMM_LITTLE_ENDIAN
+	const int r = format.rShift / 8, g = format.gShift / 8, b = format.bShift / 8;
+#else
+	const int r = 3 - format.rShift / 8, g = 3 - format.gShift / 8, b = 3 - format.bShift / 8;
+#endif
+	const int a = 6 - r - g - b;
+	if (format.aLoss == 0) {
+#ifdef SCUMM_LITTLE_ENDIAN
+		if (format.aShift / 8 != a || (format.aShift & 7))
+#else
+		if (3 - format.aShift / 8 != a || (format.aShift & 7))
+#endif
+			return kOrderNone;
+	}
+
+	if (r == 0 && g == 1 && b == 2 && a == 3)
+		return kOrderRGBA;
+	if (a == 0 && r == 1 && g == 2 && b == 3)
+		return kOrderARGB;
+	if (b == 0 && g == 1 && r == 2 && a == 3)
+		return kOrderBGRA;
+	if (a == 0 && b == 1 && g == 2 && r == 3)
+		return kOrderABGR;
+	return kOrderNone;
+}
 #endif
 
 /*
@@ -142,6 +188,10 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	// To keep memory framentation low this happens before allocating memory for temporary image data.
 	_outputSurface = new Graphics::Surface();
 
+	// The format libpng writes, when it differs from the one of the output
+	Graphics::PixelFormat rowFormat;
+	_hasAlpha = false;
+
 	// Images of all color formats except PNG_COLOR_TYPE_PALETTE
 	// will be transformed into ARGB images
 	if (colorType == PNG_COLOR_TYPE_PALETTE && !png_get_valid(pngPtr, infoPtr, PNG_INFO_tRNS)) {
@@ -168,8 +218,17 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			isAlpha = true;
 			png_set_expand(pngPtr);
 		}
-		_outputSurface->create(width, height, Graphics::PixelFormat(4,
-		                       8, 8, 8, isAlpha ? 8 : 0, 24, 16, 8, 0));
+		_hasAlpha = isAlpha;
+
+		const Graphics::PixelFormat defaultFormat(4, 8, 8, 8, isAlpha ? 8 : 0, 24, 16, 8, 0);
+		const Graphics::PixelFormat outputFormat = _outputPixelFormat.bytesPerPixel ? _outputPixelFormat : defaultFormat;
+		// Graphics::crossBlit() can't write 3 bytes per pixel
+		if (outputFormat.bytesPerPixel != 2 && outputFormat.bytesPerPixel != 4) {
+			png_destroy_read_struct(&pngPtr, &infoPtr, &endInfo);
+			return false;
+		}
+
+		_outputSurface->create(width, height, outputFormat);
 		if (!_outputSurface->getPixels()) {
 			error("Could not allocate memory for output image.");
 		}
@@ -181,17 +240,26 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
 			png_set_gray_to_rgb(pngPtr);
 
-		// PNGs are Big-Endian:
+		// Let libpng write the channels in the order of the output format.
+		// Other formats are decoded in the default one and converted row
+		// by row.
+		ChannelOrder order = getChannelOrder(outputFormat);
+		if (order == kOrderNone) {
+			// PNGs are Big-Endian:
 #ifdef SCUMM_LITTLE_ENDIAN
-		png_set_bgr(pngPtr);
-		png_set_swap_alpha(pngPtr);
-		if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
-			png_set_filler(pngPtr, 0xff, PNG_FILLER_BEFORE);
+			order = kOrderABGR;
 #else
-		if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
-			png_set_filler(pngPtr, 0xff, PNG_FILLER_AFTER);
+			order = kOrderRGBA;
 #endif
+			rowFormat = defaultFormat;
+		}
 
+		if (order == kOrderBGRA || order == kOrderABGR)
+			png_set_bgr(pngPtr);
+		if (order == kOrderARGB || order == kOrderABGR)
+			png_set_swap_alpha(pngPtr);
+		if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
+			png_set_filler(pngPtr, 0xff, (order == kOrderARGB || order == kOrderABGR) ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
 	}
 
 	// After the transformations have been registered, the image data is read again.
@@ -201,7 +269,31 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	width = w;
 	height = h;
 
-	if (interlaceType == PNG_INTERLACE_NONE) {
+	if (rowFormat.bytesPerPixel) {
+		// Decode into a buffer and convert the pixels to the output format
+		const uint bufferPitch = width * rowFormat.bytesPerPixel;
+		const uint bufferHeight = (interlaceType == PNG_INTERLACE_NONE) ? 1 : height;
+		byte *buffer = new byte[bufferPitch * bufferHeight];
+
+		if (interlaceType == PNG_INTERLACE_NONE) {
+			for (int i = 0; i < height; i++) {
+				png_read_row(pngPtr, buffer, NULL);
+				Graphics::crossBlit((byte *)_outputSurface->getBasePtr(0, i), buffer,
+				                    _outputSurface->pitch, bufferPitch, width, 1, _outputSurface->format, rowFormat);
+			}
+		} else {
+			png_bytep *rowPtr = new png_bytep[height];
+			for (int i = 0; i < height; i++)
+				rowPtr[i] = buffer + i * bufferPitch;
+			png_read_image(pngPtr, rowPtr);
+			delete[] rowPtr;
+
+			Graphics::crossBlit((byte *)_outputSurface->getPixels(), buffer,
+			                    _outputSurface->pitch, bufferPitch, width, height, _outputSurface->format, rowFormat);
+		}
+
+		delete[] buffer;
+	} else if (interlaceType == PNG_INTERLACE_NONE) {
 		// PNGs without interlacing can simply be read row by row.
 		for (int i = 0; i < height; i++) {
 			png_read_row(pngPtr, (png_bytep)_outputSurface->getBasePtr(0, i), NULL);
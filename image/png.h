@@ -33,6 +33,7 @@
 
 #include "common/scummsys.h"
 #include "common/textconsole.h"
+#include "graphics/pixelformat.h"
 #include "image/image_decoder.h"
 
 namespace Common {
@@ -55,12 +56,32 @@ public:
 	const Graphics::Surface *getSurface() const { return _outputSurface; }
 	const byte *getPalette() const { return _palette; }
 	uint16 getPaletteColorCount() const { return _paletteColorCount; }
+
+	/**
+	 * Request the pixel format of true color images. The decoded rows are
+	 * written straight in this format, without a separate conversion pass.
+	 * Paletted images without transparency are still decoded to CLUT8.
+	 *
+	 * By default, true color images are decoded to RGBA8888, or RGBX8888
+	 * when they have no alpha channel.
+	 *
+	 * @param format the output format, with 2 or 4 bytes per pixel
+	 */
+	void setOutputPixelFormat(const Graphics::PixelFormat &format) { _outputPixelFormat = format; }
+
+	/**
+	 * Returns whether the last decoded image had an alpha channel or
+	 * transparency information, whatever the output format.
+	 */
+	bool hasAlpha() const { return _hasAlpha; }
 private:
 	Common::SeekableReadStream *_stream;
 	byte *_palette;
 	uint16 _paletteColorCount;
 
 	Graphics::Surface *_outputSurface;
+	Graphics::PixelFormat _outputPixelFormat;
+	bool _hasAlpha;
 };
 
 } // End of namespace Image
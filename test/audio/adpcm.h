@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/adpcm.h"
+#include "audio/audiostream.h"
+
+#include "common/memstream.h"
+
+#include "test/helper.h"
+
+class ADPCMStreamTestSuite : public CxxTest::TestSuite
+{
+private:
+	static byte *createNoise(uint32 size) {
+		byte *data = (byte *)malloc(size);
+		TestRandom().fill(data, size);
+		return data;
+	}
+
+	static Audio::SeekableAudioStream *createStream(const byte *data, uint32 size, Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, size);
+		return Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+	}
+
+	// Decoding in odd sized pieces gives the same samples as in one go
+	void chunkTestTemplate(Audio::ADPCMType type, int channels, uint32 blockAlign, int unit) {
+		const uint32 size = blockAlign ? blockAlign * 20 : 10000;
+		byte *data = createNoise(size);
+
+		// Keep the IMA step indices of the block headers in range
+		if (type == Audio::kADPCMMSIma) {
+			for (uint32 block = 0; block < size; block += blockAlign) {
+				for (int i = 0; i < channels; ++i) {
+					data[block + i * 4 + 2] %= 89;
+					data[block + i * 4 + 3] = 0;
+				}
+			}
+		}
+
+		const int total = size * 2 + 64;
+		int16 *whole = new int16[total];
+		Audio::SeekableAudioStream *s = createStream(data, size, type, channels, blockAlign);
+		const int wholeCount = s->readBuffer(whole, total);
+		TS_ASSERT(wholeCount > 0);
+		TS_ASSERT(s->endOfData());
+		delete s;
+
+		int16 *pieces = new int16[total];
+		s = createStream(data, size, type, channels, blockAlign);
+		int piecesCount = 0;
+		for (int step = unit; !s->endOfData(); step = (step * 7) % (unit * 61) + unit)
+			piecesCount += s->readBuffer(pieces + piecesCount, MIN(step, total - piecesCount));
+		delete s;
+
+		TS_ASSERT_EQUALS(piecesCount, wholeCount);
+		TS_ASSERT_EQUALS(memcmp(whole, pieces, wholeCount * sizeof(int16)), 0);
+
+		delete[] whole;
+		delete[] pieces;
+		free(data);
+	}
+
+public:
+	void test_ms_ima_decode() {
+		// Header: predictor 0, step index 0, then the nibbles 7 and 0
+		byte data[8] = { 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00 };
+		Audio::SeekableAudioStream *s = createStream(data, sizeof(data), Audio::kADPCMMSIma, 1, 8);
+
+		int16 buffer[8];
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, 8), 8);
+		TS_ASSERT_EQUALS(buffer[0], 13);
+		TS_ASSERT_EQUALS(buffer[1], 15);
+		TS_ASSERT(s->endOfData());
+		delete s;
+	}
+
+	void test_oki_chunks() {
+		chunkTestTemplate(Audio::kADPCMOki, 1, 0, 1);
+	}
+
+	void test_dvi_chunks() {
+		chunkTestTemplate(Audio::kADPCMDVI, 2, 0, 2);
+	}
+
+	void test_ms_ima_chunks() {
+		chunkTestTemplate(Audio::kADPCMMSIma, 1, 256, 1);
+		chunkTestTemplate(Audio::kADPCMMSIma, 2, 512, 2);
+	}
+
+	void test_ms_chunks() {
+		chunkTestTemplate(Audio::kADPCMMS, 1, 256, 1);
+		chunkTestTemplate(Audio::kADPCMMS, 2, 512, 1);
+	}
+
+	void test_apple_chunks() {
+		chunkTestTemplate(Audio::kADPCMApple, 2, 34, 2);
+	}
+};
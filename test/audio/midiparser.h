@@ -0,0 +1,186 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+
+#include "common/array.h"
+
+class MidiParserTestSuite : public CxxTest::TestSuite
+{
+private:
+	class RecordingDriver : public MidiDriver_BASE {
+	public:
+		Common::Array<uint32> events;
+		void send(uint32 b) { events.push_back(b); }
+	};
+
+	class BatchingDriver : public RecordingDriver {
+	public:
+		Common::Array<uint> batchSizes;
+		void sendBatch(const uint32 *batch, uint count) {
+			batchSizes.push_back(count);
+			for (uint i = 0; i < count; ++i)
+				events.push_back(batch[i]);
+		}
+	};
+
+	static void writeVLQ(Common::Array<byte> &data, uint32 value) {
+		byte bytes[4];
+		int count = 0;
+		do {
+			bytes[count++] = value & 0x7F;
+			value >>= 7;
+		} while (value);
+		while (count-- > 1)
+			data.push_back(bytes[count] | 0x80);
+		data.push_back(bytes[0]);
+	}
+
+	static void writeTempo(Common::Array<byte> &data, uint32 delta, uint32 tempo) {
+		writeVLQ(data, delta);
+		data.push_back(0xFF);
+		data.push_back(0x51);
+		data.push_back(3);
+		data.push_back(tempo >> 16);
+		data.push_back(tempo >> 8);
+		data.push_back(tempo);
+	}
+
+	// A type 0 SMF with notes, controllers and tempo changes on every beat
+	static Common::Array<byte> createSong(uint beats, bool startTempo) {
+		Common::Array<byte> track;
+		if (startTempo)
+			writeTempo(track, 0, 400000);
+
+		for (uint i = 0; i < beats; ++i) {
+			const byte channel = i % 3;
+			writeVLQ(track, i ? 48 : 0);
+			track.push_back(0xB0 | channel);
+			track.push_back(7);
+			track.push_back(i & 0x7F);
+			writeVLQ(track, 0);
+			track.push_back(0x90 | channel);
+			track.push_back(40 + i % 40);
+			track.push_back(100);
+			writeVLQ(track, 48);
+			track.push_back(0x80 | channel);
+			track.push_back(40 + i % 40);
+			track.push_back(0);
+			if (i % 8 == 5)
+				writeTempo(track, 0, 300000 + (i % 5) * 50000);
+		}
+
+		writeVLQ(track, 0);
+		track.push_back(0xFF);
+		track.push_back(0x2F);
+		track.push_back(0);
+
+		static const byte header[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96, 'M', 'T', 'r', 'k' };
+		Common::Array<byte> data(header, sizeof(header));
+		data.push_back(track.size() >> 24);
+		data.push_back(track.size() >> 16);
+		data.push_back(track.size() >> 8);
+		data.push_back(track.size());
+		for (uint i = 0; i < track.size(); ++i)
+			data.push_back(track[i]);
+		return data;
+	}
+
+	static MidiParser *createParser(Common::Array<byte> &data, RecordingDriver &driver, bool indexed) {
+		MidiParser *parser = MidiParser::createParser_SMF();
+		parser->setMidiDriver(&driver);
+		parser->setTimerRate(10000);
+		if (indexed)
+			parser->property(MidiParser::mpIndexedJumps, 1);
+		TS_ASSERT(parser->loadMusic(data.begin(), data.size()));
+		return parser;
+	}
+
+	// Separate the events of each call, so that their timing is compared too
+	static void play(MidiParser *parser, RecordingDriver &driver, int calls) {
+		for (int i = 0; i < calls; ++i) {
+			parser->onTimer();
+			driver.events.push_back(0);
+		}
+	}
+
+	// Jumps with and without the index end up in the same state
+	void seekTestTemplate(bool startTempo, int playCalls) {
+		Common::Array<byte> data = createSong(400, startTempo);
+		RecordingDriver referenceDriver, indexedDriver;
+		MidiParser *reference = createParser(data, referenceDriver, false);
+		MidiParser *indexed = createParser(data, indexedDriver, true);
+
+		play(reference, referenceDriver, playCalls);
+		play(indexed, indexedDriver, playCalls);
+
+		static const uint32 ticks[] = { 5000, 100, 17000, 9600, 9601, 9647, 30000, 1, 200000, 12345 };
+		for (int i = 0; i < ARRAYSIZE(ticks); ++i) {
+			TS_ASSERT_EQUALS(reference->jumpToTick(ticks[i]), indexed->jumpToTick(ticks[i]));
+			TS_ASSERT_EQUALS(reference->getTick(), indexed->getTick());
+
+			play(reference, referenceDriver, 50);
+			play(indexed, indexedDriver, 50);
+			TS_ASSERT_EQUALS(reference->getTick(), indexed->getTick());
+			TS_ASSERT(referenceDriver.events == indexedDriver.events);
+		}
+
+		// A tempo set from outside applies to a replay until the track
+		// changes it again
+		reference->setTempo(700000);
+		indexed->setTempo(700000);
+		for (int i = 0; i < ARRAYSIZE(ticks); ++i) {
+			TS_ASSERT_EQUALS(reference->jumpToTick(ticks[i]), indexed->jumpToTick(ticks[i]));
+			play(reference, referenceDriver, 20);
+			play(indexed, indexedDriver, 20);
+			TS_ASSERT_EQUALS(reference->getTick(), indexed->getTick());
+			TS_ASSERT(referenceDriver.events == indexedDriver.events);
+		}
+
+		delete reference;
+		delete indexed;
+	}
+
+public:
+	void test_seek_after_playback() {
+		seekTestTemplate(true, 3000);
+	}
+
+	void test_seek_without_playback() {
+		seekTestTemplate(true, 0);
+	}
+
+	void test_seek_default_start_tempo() {
+		seekTestTemplate(false, 1000);
+		seekTestTemplate(false, 0);
+	}
+
+	void test_batched_sends() {
+		Common::Array<byte> data = createSong(100, true);
+		RecordingDriver plainDriver;
+		BatchingDriver batchingDriver;
+		MidiParser *plain = createParser(data, plainDriver, false);
+		MidiParser *batching = createParser(data, batchingDriver, false);
+
+		// Each call covers a few beats, the tempo changes split some of them
+		plain->setTimerRate(500000);
+		batching->setTimerRate(500000);
+		play(plain, plainDriver, 40);
+		play(batching, batchingDriver, 40);
+		TS_ASSERT(plainDriver.events == batchingDriver.events);
+		TS_ASSERT(!batchingDriver.batchSizes.empty());
+		for (uint i = 0; i < batchingDriver.batchSizes.size(); ++i)
+			TS_ASSERT(batchingDriver.batchSizes[i] > 1);
+
+		// A jump turns off the notes with a single call
+		TS_ASSERT(batching->jumpToTick(48 * 10));
+		play(batching, batchingDriver, 1);
+		batchingDriver.batchSizes.clear();
+		TS_ASSERT(batching->jumpToTick(0));
+		TS_ASSERT_EQUALS(batchingDriver.batchSizes.size(), 1u);
+		TS_ASSERT(!batchingDriver.batchSizes.empty() && batchingDriver.batchSizes[0] >= 16);
+
+		delete plain;
+		delete batching;
+	}
+};
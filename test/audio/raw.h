@@ -3,11 +3,21 @@
 #include "audio/decoders/raw.h"
 #include "audio/audiostream.h"
 
+#include "common/substream.h"
+
 #include "helper.h"
+#include "test/helper.h"
 
 class RawStreamTestSuite : public CxxTest::TestSuite
 {
 private:
+	/** A memory stream which hides its memory, so that it is read through read() */
+	class HiddenMemoryReadStream : public Common::MemoryReadStream {
+	public:
+		HiddenMemoryReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size) {}
+		const byte *getMemory() const { return 0; }
+	};
+
 	template<typename T>
 	void readBufferTestTemplate(const int sampleRate, const int time, const bool le, const bool isStereo) {
 		int16 *sine;
@@ -288,4 +298,59 @@ public:
 	void test_seek_stereo() {
 		seekTest(11025, 2, true);
 	}
+
+private:
+	// Converting straight from memory gives the same samples as reading.
+	// The streams are passed on at the given position.
+	void memoryTestTemplate(byte flags, uint32 start = 0) {
+		// Random data at an odd address, with an odd number of samples
+		const uint32 size = 4002;
+		byte *data = new byte[size + 1];
+		TestRandom().fill(data, size + 1);
+
+		Common::SeekableSubReadStream *sub = new Common::SeekableSubReadStream(new Common::MemoryReadStream(data, size + 1), 1, size + 1, DisposeAfterUse::YES);
+		TS_ASSERT_EQUALS(sub->getMemory(), data + 1);
+		sub->seek(start);
+		Common::SeekableReadStream *hidden = new HiddenMemoryReadStream(data + 1, size);
+		hidden->seek(start);
+		Audio::SeekableAudioStream *fromMemory = Audio::makeRawStream(sub, 22050, flags);
+		Audio::SeekableAudioStream *fromStream = Audio::makeRawStream(hidden, 22050, flags);
+
+		int16 bufferMemory[300], bufferStream[300];
+		for (int step = 1; !fromStream->endOfData(); step = (step * 7) % 293 + 1) {
+			const int count = fromStream->readBuffer(bufferStream, step);
+			TS_ASSERT_EQUALS(fromMemory->readBuffer(bufferMemory, step), count);
+			TS_ASSERT_EQUALS(memcmp(bufferMemory, bufferStream, count * sizeof(int16)), 0);
+			TS_ASSERT_EQUALS(fromMemory->endOfData(), fromStream->endOfData());
+		}
+		TS_ASSERT_EQUALS(fromMemory->readBuffer(bufferMemory, 1), 0);
+
+		// Reading continues from where a seek lands
+		const Audio::Timestamp where(0, 1000, 22050);
+		TS_ASSERT(fromMemory->seek(where));
+		TS_ASSERT(fromStream->seek(where));
+		TS_ASSERT_EQUALS(fromMemory->readBuffer(bufferMemory, 299), fromStream->readBuffer(bufferStream, 299));
+		TS_ASSERT_EQUALS(memcmp(bufferMemory, bufferStream, 299 * sizeof(int16)), 0);
+
+		delete fromMemory;
+		delete fromStream;
+		delete[] data;
+	}
+
+public:
+	void test_memory_8_bit() {
+		memoryTestTemplate(0);
+		memoryTestTemplate(Audio::FLAG_UNSIGNED);
+	}
+
+	void test_memory_16_bit() {
+		memoryTestTemplate(Audio::FLAG_16BITS);
+		memoryTestTemplate(Audio::FLAG_16BITS | Audio::FLAG_UNSIGNED);
+		memoryTestTemplate(Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		memoryTestTemplate(Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | Audio::FLAG_UNSIGNED);
+
+		// An odd number of bytes is left, the last one is not a whole sample
+		memoryTestTemplate(Audio::FLAG_16BITS, 1);
+		memoryTestTemplate(Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, 1);
+	}
 };
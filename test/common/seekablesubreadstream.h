@@ -70,4 +70,18 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_memory() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+		TS_ASSERT_EQUALS(ms.getMemory(), contents);
+
+		// The memory of a substream starts where the substream does
+		Common::SeekableSubReadStream ssrs(&ms, 3, 9);
+		ssrs.seek(2);
+		TS_ASSERT_EQUALS(ssrs.getMemory(), contents + 3);
+
+		Common::SeekableSubReadStream nested(&ssrs, 1, 4);
+		TS_ASSERT_EQUALS(nested.getMemory(), contents + 4);
+	}
 };
@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/microtiles.h"
+
+#include "test/helper.h"
+
+class MicroTileArrayTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_single_rect() {
+		Graphics::MicroTileArray tiles(640, 480);
+		TS_ASSERT(tiles.isEmpty());
+
+		tiles.addRect(Common::Rect(10, 20, 110, 90));
+		TS_ASSERT(!tiles.isEmpty());
+		TS_ASSERT_EQUALS(tiles.getBoundingRect(), Common::Rect(10, 20, 110, 90));
+
+		// A rectangle spanning several tiles comes back in one piece
+		Common::Array<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(10, 20, 110, 90));
+
+		tiles.clear();
+		TS_ASSERT(tiles.isEmpty());
+		rects.clear();
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 0u);
+	}
+
+	void test_clipping() {
+		Graphics::MicroTileArray tiles(100, 50);
+
+		tiles.addRect(Common::Rect(-20, -20, 0, 0));
+		tiles.addRect(Common::Rect(200, 10, 300, 20));
+		tiles.addRect(Common::Rect(30, 30, 30, 40));
+		TS_ASSERT(tiles.isEmpty());
+
+		tiles.addRect(Common::Rect(90, 40, 150, 150));
+		Common::List<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects.front(), Common::Rect(90, 40, 100, 50));
+
+		tiles.addAll();
+		rects.clear();
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects.front(), Common::Rect(100, 50));
+	}
+
+	void test_small_rects() {
+		Graphics::MicroTileArray tiles(64, 64);
+
+		// A single pixel at the origin of a tile is not an empty tile
+		tiles.addRect(Common::Rect(32, 0, 33, 1));
+		Common::Array<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(32, 0, 33, 1));
+	}
+
+	void test_resize() {
+		Graphics::MicroTileArray tiles(64, 64);
+		tiles.addRect(Common::Rect(10, 10, 20, 20));
+
+		tiles.resize(320, 200);
+		TS_ASSERT(tiles.isEmpty());
+		TS_ASSERT_EQUALS(tiles.getWidth(), 320);
+		TS_ASSERT_EQUALS(tiles.getHeight(), 200);
+
+		tiles.addRect(Common::Rect(300, 180, 320, 200));
+		Common::Array<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(300, 180, 320, 200));
+	}
+
+	void test_coverage() {
+		const int w = 200, h = 150;
+		Graphics::MicroTileArray tiles(w, h);
+		byte added[w * h];
+		memset(added, 0, sizeof(added));
+
+		TestRandom rng;
+		for (int i = 0; i < 40; ++i) {
+			uint32 seed = rng.next();
+			const int16 x = (seed >> 8) % w, y = (seed >> 16) % h;
+			seed = rng.next();
+			const Common::Rect r(x, y, x + 1 + (seed >> 8) % 60, y + 1 + (seed >> 16) % 60);
+			tiles.addRect(r);
+
+			for (int py = r.top; py < MIN<int>(r.bottom, h); ++py)
+				for (int px = r.left; px < MIN<int>(r.right, w); ++px)
+					added[py * w + px] = 1;
+		}
+
+		// Every added pixel is covered exactly once
+		byte covered[w * h];
+		memset(covered, 0, sizeof(covered));
+
+		Common::Array<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		for (uint i = 0; i < rects.size(); ++i) {
+			const Common::Rect &r = rects[i];
+			TS_ASSERT(Common::Rect(w, h).contains(r));
+			for (int py = r.top; py < r.bottom; ++py)
+				for (int px = r.left; px < r.right; ++px)
+					++covered[py * w + px];
+		}
+
+		for (int i = 0; i < w * h; ++i) {
+			TS_ASSERT(covered[i] <= 1);
+			if (added[i])
+				TS_ASSERT_EQUALS(covered[i], 1);
+		}
+	}
+
+	void test_vertical_merge() {
+		Graphics::MicroTileArray tiles(320, 200);
+
+		// A tall rectangle spanning several rows of tiles is a single one
+		tiles.addRect(Common::Rect(40, 10, 70, 190));
+		Common::Array<Common::Rect> rects;
+		tiles.getRectangles(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(40, 10, 70, 190));
+	}
+};
@@ -0,0 +1,76 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transformed_surface_cache.h"
+#include "graphics/transparent_surface.h"
+
+class TransformedSurfaceCacheTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_hits_and_misses() {
+		Graphics::TransparentSurface src;
+		src.create(16, 16, Graphics::TransparentSurface::getSupportedPixelFormat());
+		src.fillRect(Common::Rect(16, 16), 0xFF00FF00);
+		const Common::Rect area(16, 16);
+
+		Graphics::TransformedSurfaceCache cache;
+		Graphics::TransformedSurfaceCache::SurfacePtr first = cache.scale(&src, area, src, 32, 24);
+		TS_ASSERT_EQUALS(first->w, 32);
+		TS_ASSERT_EQUALS(first->h, 24);
+		TS_ASSERT_EQUALS(*(const uint32 *)first->getBasePtr(31, 23), 0xFF00FF00u);
+		TS_ASSERT_EQUALS(cache.getMisses(), 1u);
+
+		Graphics::TransformedSurfaceCache::SurfacePtr second = cache.scale(&src, area, src, 32, 24);
+		TS_ASSERT_EQUALS(first.get(), second.get());
+		TS_ASSERT_EQUALS(cache.getHits(), 1u);
+
+		// A different size or source area is a different entry
+		cache.scale(&src, area, src, 8, 8);
+		cache.scale(&src, Common::Rect(8, 8), src.getSubArea(Common::Rect(8, 8)), 32, 24);
+		TS_ASSERT_EQUALS(cache.getMisses(), 3u);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 3u);
+		TS_ASSERT_EQUALS(cache.getBytes(), (uint32)(32 * 24 + 8 * 8 + 32 * 24) * 4);
+
+		// Invalidated surfaces are gone from the cache, but stay valid for their users
+		cache.invalidate(&src);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 0u);
+		TS_ASSERT_EQUALS(cache.getBytes(), 0u);
+		TS_ASSERT_EQUALS(*(const uint32 *)first->getBasePtr(0, 0), 0xFF00FF00u);
+		Graphics::TransformedSurfaceCache::SurfacePtr third = cache.scale(&src, area, src, 32, 24);
+		TS_ASSERT_DIFFERS(first.get(), third.get());
+
+		src.free();
+	}
+
+	void test_eviction() {
+		Graphics::TransparentSurface src;
+		src.create(4, 4, Graphics::TransparentSurface::getSupportedPixelFormat());
+		const Common::Rect area(4, 4);
+		const int owners[3] = { 0, 1, 2 };
+
+		// Room for two 8x8 surfaces
+		Graphics::TransformedSurfaceCache cache(2 * 8 * 8 * 4);
+		cache.scale(&owners[0], area, src, 8, 8);
+		cache.scale(&owners[1], area, src, 8, 8);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 2u);
+
+		// Using the first surface makes the second one the least recently used
+		cache.scale(&owners[0], area, src, 8, 8);
+		cache.scale(&owners[2], area, src, 8, 8);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 2u);
+		TS_ASSERT_EQUALS(cache.getEvictions(), 1u);
+
+		cache.scale(&owners[0], area, src, 8, 8);
+		TS_ASSERT_EQUALS(cache.getHits(), 2u);
+		cache.scale(&owners[1], area, src, 8, 8);
+		TS_ASSERT_EQUALS(cache.getHits(), 2u);
+
+		// Surfaces larger than the budget are not cached at all
+		cache.scale(&owners[0], area, src, 64, 64);
+		TS_ASSERT_LESS_THAN_EQUALS(cache.getBytes(), cache.getMaxBytes());
+
+		cache.setMaxBytes(0);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 0u);
+
+		src.free();
+	}
+};
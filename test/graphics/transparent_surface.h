@@ -0,0 +1,101 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+#include "test/helper.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+	TestRandom _random;
+
+	uint32 nextRandom() {
+		return _random.next() >> 8;
+	}
+
+	void fillRandom(Graphics::Surface &surf) {
+		for (int y = 0; y < surf.h; ++y) {
+			uint32 *row = (uint32 *)surf.getBasePtr(0, y);
+			for (int x = 0; x < surf.w; ++x) {
+				uint32 pixel = (nextRandom() << 8) ^ nextRandom();
+				// Make sure fully transparent and fully opaque pixels are common
+				switch (nextRandom() & 3) {
+				case 0:
+					pixel &= 0x00FFFFFF;
+					break;
+				case 1:
+					pixel |= 0xFF000000;
+					break;
+				default:
+					break;
+				}
+				row[x] = pixel;
+			}
+		}
+	}
+
+	/**
+	 * Blits src onto a copy of dst, with either the SIMD or the plain C
+	 * blending routines.
+	 */
+	void blitOnto(Graphics::TransparentSurface &src, const Graphics::Surface &dst, Graphics::Surface &result,
+	              bool simd, int flipping, uint color, Graphics::TSpriteBlendMode blendMode) {
+		result.copyFrom(dst);
+		Graphics::TransparentSurface::setSIMDBlending(simd);
+		src.blit(result, 3, 1, flipping, nullptr, color, -1, -1, blendMode);
+	}
+
+	public:
+	void test_simd_blending_matches_scalar() {
+		// Colour modulations, in 0xAARRGGBB format
+		static const uint colors[] = {
+			0xFFFFFFFF,
+			0xC86496FA,
+			0x80FF28FF,
+			0xFF00FF01
+		};
+		static const Graphics::TSpriteBlendMode blendModes[] = {
+			Graphics::BLEND_NORMAL,
+			Graphics::BLEND_ADDITIVE,
+			Graphics::BLEND_SUBTRACTIVE
+		};
+		static const Graphics::AlphaType alphaModes[] = {
+			Graphics::ALPHA_BINARY,
+			Graphics::ALPHA_FULL
+		};
+
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		_random = TestRandom(42);
+
+		// Cover every width modulo the SIMD vector size
+		for (int width = 1; width <= 11; ++width) {
+			Graphics::TransparentSurface src;
+			src.create(width, 3, format);
+			fillRandom(src);
+
+			Graphics::Surface dst;
+			dst.create(width + 8, 5, format);
+			fillRandom(dst);
+
+			for (int a = 0; a < ARRAYSIZE(alphaModes); ++a) {
+				src.setAlphaMode(alphaModes[a]);
+				for (int b = 0; b < ARRAYSIZE(blendModes); ++b) {
+					for (int c = 0; c < ARRAYSIZE(colors); ++c) {
+						for (int flipping = Graphics::FLIP_NONE; flipping <= Graphics::FLIP_HV; ++flipping) {
+							Graphics::Surface scalar, simd;
+							blitOnto(src, dst, scalar, false, flipping, colors[c], blendModes[b]);
+							blitOnto(src, dst, simd, true, flipping, colors[c], blendModes[b]);
+							TS_ASSERT_EQUALS(memcmp(scalar.getPixels(), simd.getPixels(), dst.pitch * dst.h), 0);
+							scalar.free();
+							simd.free();
+						}
+					}
+				}
+			}
+
+			src.free();
+			dst.free();
+		}
+
+		Graphics::TransparentSurface::setSIMDBlending(true);
+	}
+};
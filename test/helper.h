@@ -0,0 +1,30 @@
+#ifndef TEST_HELPER_H
+#define TEST_HELPER_H
+
+#include "common/scummsys.h"
+
+/**
+ * The linear congruential generator the tests build their random data
+ * with, so that every run works on the same data.
+ */
+class TestRandom {
+public:
+	TestRandom(uint32 seed = 0x12345678) : _seed(seed) {}
+
+	/** Returns the next state. The low bits are not very random. */
+	uint32 next() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed;
+	}
+
+	/** Fills a buffer with random bytes. */
+	void fill(byte *data, uint32 size) {
+		for (uint32 i = 0; i < size; ++i)
+			data[i] = next() >> 16;
+	}
+
+private:
+	uint32 _seed;
+};
+
+#endif